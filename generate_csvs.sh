@@ -12,10 +12,7 @@ fi
 
 cmake --build build --config Release
 
-./build/counting_sort
-./build/quick_sort
-./build/quick_sort_3way
-./build/intro_sort
+./build/sortbench
 
 platform_specific_dir="$(whoami)_$(uname)_$(uname -m)"
 if [ ! -d "./results/$platform_specific_dir" ]; then
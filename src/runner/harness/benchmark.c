@@ -0,0 +1,1405 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+
+#include "sorts/task_pool.h"
+#include "sorts/partition.h"
+#include "sorts/stats.h"
+#include "sorts/scan.h"
+#include "harness/runner.h"
+
+Runner g_runner;
+
+static const char* g_distribution_names[RUNNERDISTRIBUTION_COUNT] = {
+	"uniform",
+	"sorted",
+	"reversed",
+	"organpipe",
+	"fewunique",
+	"sortedtail",
+	"nearlysorted",
+};
+
+static const char* g_timing_names[RUNNERTIMING_COUNT] = {
+	"subtract",
+	"pool",
+};
+
+const char* runnertiming_name(Runner_Timing timing) {
+	return g_timing_names[timing];
+}
+
+bool runnertiming_parse(const char* name, Runner_Timing* timing) {
+	for (size_t i = 0; i < RUNNERTIMING_COUNT; i += 1) {
+		if (strcmp(g_timing_names[i], name) == 0) {
+			*timing = (Runner_Timing)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const char* runnerdistribution_name(Runner_Distribution distribution) {
+	return g_distribution_names[distribution];
+}
+
+bool runnerdistribution_parse(const char* name, Runner_Distribution* distribution) {
+	for (size_t i = 0; i < RUNNERDISTRIBUTION_COUNT; i += 1) {
+		if (strcmp(g_distribution_names[i], name) == 0) {
+			*distribution = (Runner_Distribution)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+size_t calculate_array_length(size_t iteration) {
+	double b_power = pow(g_runner.length_constant_b, (double)iteration);
+	return (size_t)(g_runner.length_constant_a * b_power);
+}
+
+size_t calculate_large_array_length(size_t iteration) {
+	double b_power = pow(g_runner.large_length_constant_b, (double)iteration);
+	return (size_t)(g_runner.large_length_constant_a * b_power);
+}
+
+int64_t calculate_input_range(size_t iteration) {
+	double b_power = pow(g_runner.input_range_constant_b, (double)iteration);
+	return (int64_t)(g_runner.input_range_constant_a * b_power);
+}
+
+void randomize_array(Runner_Worker* worker, int64_t* array, size_t array_length, int64_t minimum_element, int64_t maximum_element) {
+	runnerrandom_fill(&worker->random, array, array_length, minimum_element, maximum_element);
+
+	size_t max_element_index = (size_t)runnerrandom_bounded(&worker->random, array_length);
+	array[max_element_index] = maximum_element;
+
+	size_t min_element_index;
+	do {
+		min_element_index = (size_t)runnerrandom_bounded(&worker->random, array_length);
+	} while(array_length != 1 && min_element_index == max_element_index);
+	array[min_element_index] = minimum_element;
+}
+
+int64_t calculate_spread_element(size_t i, size_t count, int64_t minimum_element, int64_t maximum_element) {
+	if (count <= 1) {
+		return minimum_element;
+	}
+
+	uint64_t range = (uint64_t)(maximum_element - minimum_element);
+	return minimum_element + (int64_t)(range * i / (count - 1));
+}
+
+void generate_array(Runner_Worker* worker, Runner_Distribution distribution, int64_t* array, size_t array_length, int64_t minimum_element, int64_t maximum_element) {
+	switch (distribution) {
+	case RUNNERDISTRIBUTION_UNIFORM:
+		randomize_array(worker, array, array_length, minimum_element, maximum_element);
+		break;
+	case RUNNERDISTRIBUTION_SORTED:
+		for (size_t i = 0; i < array_length; i++) {
+			array[i] = calculate_spread_element(i, array_length, minimum_element, maximum_element);
+		}
+		break;
+	case RUNNERDISTRIBUTION_REVERSED:
+		for (size_t i = 0; i < array_length; i++) {
+			array[array_length - 1 - i] = calculate_spread_element(i, array_length, minimum_element, maximum_element);
+		}
+		break;
+	case RUNNERDISTRIBUTION_ORGAN_PIPE: {
+		size_t half_length = (array_length + 1) / 2;
+		for (size_t i = 0; i < half_length; i++) {
+			int64_t element = calculate_spread_element(i, half_length, minimum_element, maximum_element);
+			array[i] = element;
+			array[array_length - 1 - i] = element;
+		}
+		break;
+	}
+	case RUNNERDISTRIBUTION_FEW_UNIQUE:
+		randomize_array(worker, array, array_length, 0, RUNNER_FEW_UNIQUE_VALUES - 1);
+		for (size_t i = 0; i < array_length; i++) {
+			array[i] = calculate_spread_element((size_t)array[i], RUNNER_FEW_UNIQUE_VALUES, minimum_element, maximum_element);
+		}
+		break;
+	case RUNNERDISTRIBUTION_SORTED_TAIL: {
+		size_t tail_length = array_length / RUNNER_PRESORTED_DISORDER + 1;
+		if (tail_length > array_length) {
+			tail_length = array_length;
+		}
+
+		size_t sorted_length = array_length - tail_length;
+		for (size_t i = 0; i < sorted_length; i++) {
+			array[i] = calculate_spread_element(i, sorted_length, minimum_element, maximum_element);
+		}
+		runnerrandom_fill(&worker->random, array + sorted_length, tail_length, minimum_element, maximum_element);
+		break;
+	}
+	case RUNNERDISTRIBUTION_NEARLY_SORTED: {
+		for (size_t i = 0; i < array_length; i++) {
+			array[i] = calculate_spread_element(i, array_length, minimum_element, maximum_element);
+		}
+
+		size_t swap_count = array_length / RUNNER_PRESORTED_DISORDER / 2 + 1;
+		for (size_t i = 0; i < swap_count; i++) {
+			size_t a = (size_t)runnerrandom_bounded(&worker->random, array_length);
+			size_t b = (size_t)runnerrandom_bounded(&worker->random, array_length);
+			int64_t element = array[a];
+			array[a] = array[b];
+			array[b] = element;
+		}
+		break;
+	}
+	default:
+		assert(false);
+	}
+}
+
+// Converts, in place, array_length int64_t elements to the given type. The
+// generated elements are small enough to be exact in every type.
+void convert_array(Element_Type element_type, void* array, size_t array_length) {
+	int64_t* source = array;
+
+	// Every element is written at or before the one it is read from
+	switch (element_type) {
+	case ELEMENTTYPE_INT64:
+		break;
+	case ELEMENTTYPE_UINT64:
+		for (size_t i = 0; i < array_length; i += 1) {
+			((uint64_t*)array)[i] = (uint64_t)source[i];
+		}
+		break;
+	case ELEMENTTYPE_DOUBLE:
+		for (size_t i = 0; i < array_length; i += 1) {
+			((double*)array)[i] = (double)source[i];
+		}
+		break;
+	case ELEMENTTYPE_INT32:
+		for (size_t i = 0; i < array_length; i += 1) {
+			((int32_t*)array)[i] = (int32_t)source[i];
+		}
+		break;
+	case ELEMENTTYPE_UINT32:
+		for (size_t i = 0; i < array_length; i += 1) {
+			((uint32_t*)array)[i] = (uint32_t)source[i];
+		}
+		break;
+	case ELEMENTTYPE_FLOAT:
+		for (size_t i = 0; i < array_length; i += 1) {
+			((float*)array)[i] = (float)source[i];
+		}
+		break;
+	default:
+		assert(false);
+	}
+}
+
+void generate_typed_array(Runner_Worker* worker, Runner_Distribution distribution, Element_Type element_type, void* array, size_t array_length, int64_t minimum_element, int64_t maximum_element) {
+	generate_array(worker, distribution, array, array_length, minimum_element, maximum_element);
+	convert_array(element_type, array, array_length);
+}
+
+bool is_array_sorted(int64_t* array, size_t array_length) {
+	return scan_is_sorted(array, array_length);
+}
+
+double timespec_duration(struct timespec start, struct timespec end) {
+	return end.tv_sec - start.tv_sec
+		+ ((end.tv_nsec - start.tv_nsec ) / (double) 1000000000.0);
+}
+
+void calculate_clock_precision(void) {
+	struct timespec start;
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &end);
+	} while (timespec_duration(start, end) == 0.0);
+
+	g_runner.clock_precision =  timespec_duration(start, end);
+	g_runner.min_execution_time = g_runner.clock_precision * ((1.0 / RUNNER_MAX_RELATIVE_ERROR) + 1.0);
+}
+
+void calculate_array_init_time(Runner_Worker* worker, Runner_Distribution distribution, Element_Type element_type) {
+	double total_duration = 0.0;
+	size_t initialization_count = 0;
+	struct timespec start;
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	do {
+		generate_typed_array(worker,
+			distribution,
+			element_type,
+			worker->array_buffer,
+			worker->array_buffer_size,
+			RUNNER_MIN_ARRAY_ELEMENT,
+			RUNNER_MAX_ARRAY_ELEMENT
+		);
+
+		initialization_count += 1;
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		total_duration = timespec_duration(start, end);
+	} while(total_duration < g_runner.min_execution_time);
+
+	g_runner.array_average_init_time[distribution][element_type] =
+		total_duration / (double)initialization_count / (double)worker->array_buffer_size * 0.8;
+}
+
+void noop_kernel(int64_t* array, size_t array_length) {
+	(void)array;
+	(void)array_length;
+}
+
+// Time still measured by the input pool besides the kernels: the timestamps
+// around every batch and the calls to the kernel
+void calculate_harness_overhead(void) {
+	double total_duration = 0.0;
+	size_t timestamp_count = 0;
+	struct timespec start;
+	struct timespec end;
+
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		total_duration += timespec_duration(start, end);
+		timestamp_count += 1;
+	} while(total_duration < g_runner.min_execution_time);
+	g_runner.batch_overhead = total_duration / (double)timestamp_count;
+
+	// Called through a volatile pointer, like the kernels it cannot be inlined
+	Sort_Function volatile function = noop_kernel;
+	int64_t element = 0;
+	size_t call_count = 0;
+
+	total_duration = 0.0;
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (size_t i = 0; i < RUNNER_INPUT_POOL_MAX_ARRAYS; i += 1) {
+			function(&element, 1);
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		total_duration += timespec_duration(start, end);
+		call_count += RUNNER_INPUT_POOL_MAX_ARRAYS;
+	} while(total_duration < g_runner.min_execution_time);
+	g_runner.call_overhead = (total_duration - g_runner.batch_overhead * (double)(call_count / RUNNER_INPUT_POOL_MAX_ARRAYS)) / (double)call_count;
+	if (g_runner.call_overhead < 0.0) {
+		g_runner.call_overhead = 0.0;
+	}
+}
+
+void runnerworker_create(Runner_Worker* worker, size_t cpu, size_t array_buffer_size) {
+	// With the input pool the array buffer holds a whole batch of arrays
+	size_t buffer_capacity = array_buffer_size;
+	if (g_runner.timing == RUNNERTIMING_INPUT_POOL && buffer_capacity < RUNNER_INPUT_POOL_LENGTH) {
+		buffer_capacity = RUNNER_INPUT_POOL_LENGTH;
+	}
+
+	worker->array_buffer = malloc(sizeof(int64_t) * buffer_capacity);
+	assert(worker->array_buffer != NULL);
+	worker->array_buffer_size = array_buffer_size;
+
+	worker->input_pool = NULL;
+	if (g_runner.timing == RUNNERTIMING_INPUT_POOL) {
+		worker->input_pool = malloc(sizeof(int64_t) * buffer_capacity);
+		assert(worker->input_pool != NULL);
+	}
+	worker->input_pool_capacity = buffer_capacity;
+
+	runnerrandom_seed(&worker->random, g_runner.generator, g_runner.seed);
+	worker->cpu = cpu;
+
+	scratcharena_create(&worker->scratch, 0);
+
+	worker->record_layout = RECORDLAYOUT_AOS;
+	worker->payload_size = 0;
+	worker->record_pool = NULL;
+	worker->record_buffer = NULL;
+	worker->record_buffer_capacity = 0;
+
+	worker->counters.group_descriptor = -1;
+	for (size_t i = 0; i < RUNNERCOUNTER_COUNT; i += 1) {
+		worker->counters.descriptors[i] = -1;
+	}
+}
+
+void runnerworker_destroy(Runner_Worker* worker) {
+	free(worker->array_buffer);
+	free(worker->input_pool);
+	free(worker->record_pool);
+	free(worker->record_buffer);
+	scratcharena_destroy(&worker->scratch);
+}
+
+// Every benchmark point gets its own seed, so that the arrays it sorts do not
+// depend on which worker measures it nor on the points measured before it
+uint64_t runner_point_seed(Runner_Axis axis, size_t iteration) {
+	return g_runner.seed + (uint64_t)axis * RUNNER_TEST_COUNT + iteration;
+}
+
+void runnerworker_seed(Runner_Worker* worker, Runner_Axis axis, size_t iteration) {
+	runnerrandom_seed(&worker->random, g_runner.generator, runner_point_seed(axis, iteration));
+}
+
+void collect_run_metadata(const Runner_Options* options) {
+	runner_metadata_collect(g_runner.metadata, sizeof(g_runner.metadata));
+
+	char value[64];
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "timing", runnertiming_name(g_runner.timing));
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "generator", runnergenerator_name(g_runner.generator));
+	snprintf(value, sizeof(value), "%llu", (unsigned long long)g_runner.seed);
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "seed", value);
+	snprintf(value, sizeof(value), "%llu", (unsigned long long)g_runner.sample_count);
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "sample_count", value);
+	snprintf(value, sizeof(value), "%g", g_runner.target_precision);
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "target_precision", value);
+	snprintf(value, sizeof(value), "%g", g_runner.point_time_budget);
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "point_time_budget", value);
+	snprintf(value, sizeof(value), "%llu", (unsigned long long)g_runner.thread_count);
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "thread_count", value);
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "physical_cores_only", options->physical_cores_only ? "1" : "0");
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "large_array_lengths", options->large_array_lengths ? "1" : "0");
+	snprintf(value, sizeof(value), "%.17g", g_runner.clock_precision);
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "clock_precision", value);
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "scan_isa", scanisa_name(scan_isa()));
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "small_sort_isa", scanisa_name(smallsort_isa()));
+	snprintf(value, sizeof(value), "%llu", (unsigned long long)sorts_counting_memory_cap());
+	runner_metadata_append(g_runner.metadata, sizeof(g_runner.metadata), "counting_memory_cap", value);
+}
+
+void runner_init(const Runner_Options* options) {
+	calculate_clock_precision();
+
+	g_runner.length_constant_a = (double)RUNNER_STARTING_ARRAY_LENGTH;
+	g_runner.length_constant_b = pow(
+		(double)RUNNER_ENDING_ARRAY_LENGTH / (double)RUNNER_STARTING_ARRAY_LENGTH,
+		1.0 / (double)(RUNNER_TEST_COUNT - 1)
+	);
+
+	g_runner.large_array_lengths = options->large_array_lengths;
+	g_runner.large_length_constant_a = (double)RUNNER_LARGE_STARTING_ARRAY_LENGTH;
+	g_runner.large_length_constant_b = pow(
+		(double)RUNNER_LARGE_ENDING_ARRAY_LENGTH / (double)RUNNER_LARGE_STARTING_ARRAY_LENGTH,
+		1.0 / (double)(RUNNER_LARGE_ARRAY_LENGTH_COUNT - 1)
+	);
+
+	g_runner.input_range_constant_a = (double)RUNNER_STARTING_ELEMENT_RANGE;
+	g_runner.input_range_constant_b = pow(
+		(double)RUNNER_ENDING_ELEMENT_RANGE / (double)RUNNER_STARTING_ELEMENT_RANGE,
+		1.0 / (double)(RUNNER_TEST_COUNT - 1)
+	);
+
+	g_runner.cpus_count = runner_list_cpus(g_runner.cpus, RUNNER_MAX_THREADS, options->physical_cores_only);
+	assert(g_runner.cpus_count > 0);
+
+	g_runner.thread_count = options->thread_count;
+	if (g_runner.thread_count == 0 || g_runner.thread_count > g_runner.cpus_count) {
+		g_runner.thread_count = g_runner.cpus_count;
+	}
+	// Pinning is skipped for sequential runs, which keep the old behaviour of
+	// letting the scheduler place the only measuring thread
+	g_runner.pin_threads = g_runner.thread_count > 1;
+
+	g_runner.timing = options->timing;
+	g_runner.generator = options->generator;
+	g_runner.seed = options->seed;
+	g_runner.sample_count = options->sample_count > 0 ? options->sample_count : 1;
+	g_runner.target_precision = options->target_precision;
+	g_runner.point_time_budget = options->point_time_budget;
+	g_runner.min_sample_execution_time = g_runner.clock_precision * ((1.0 / RUNNER_ADAPTIVE_SAMPLE_RELATIVE_ERROR) + 1.0);
+	g_runner.write_samples = g_runner.sample_count > 1 || g_runner.target_precision > 0.0;
+	g_runner.output_format = options->output_format;
+	collect_run_metadata(options);
+	if (g_runner.timing == RUNNERTIMING_INPUT_POOL) {
+		calculate_harness_overhead();
+	}
+
+	g_runner.workers = malloc(sizeof(Runner_Worker) * g_runner.thread_count);
+	assert(g_runner.workers != NULL);
+	for (size_t i = 0; i < g_runner.thread_count; i += 1) {
+		runnerworker_create(&g_runner.workers[i], g_runner.cpus[i], RUNNER_ENDING_ARRAY_LENGTH);
+	}
+
+	runnerworker_seed(&g_runner.workers[0], RUNNERAXIS_ARRAY_LENGTH, 0);
+	for (size_t i = 0; i < RUNNERDISTRIBUTION_COUNT; i += 1) {
+		for (size_t j = 0; j < ELEMENTTYPE_COUNT; j += 1) {
+			calculate_array_init_time(&g_runner.workers[0], (Runner_Distribution)i, (Element_Type)j);
+		}
+	}
+
+	g_runner.counters_enabled = false;
+	if (options->hardware_counters) {
+		Runner_Counters counters;
+		g_runner.counters_enabled = runnercounters_open(&counters);
+		runnercounters_close(&counters);
+
+		if (!g_runner.counters_enabled) {
+			fprintf(stderr, "Hardware counters are not available (see /proc/sys/kernel/perf_event_paranoid), their columns will be nan\n");
+		}
+	}
+
+	printf("Benchmarking on %llu thread(s)%s, %s timing, %s generator from seed %llu\n",
+		(unsigned long long)g_runner.thread_count,
+		options->physical_cores_only ? ", one per physical core" : "",
+		runnertiming_name(g_runner.timing),
+		runnergenerator_name(g_runner.generator),
+		(unsigned long long)g_runner.seed
+	);
+	if (g_runner.timing == RUNNERTIMING_INPUT_POOL) {
+		printf("Harness overhead: %.17fs per batch, %.17fs per sort\n",
+			g_runner.batch_overhead,
+			g_runner.call_overhead
+		);
+	}
+	if (g_runner.target_precision > 0.0) {
+		printf("Sampling every point until +-%.3f%% or %.3fs\n",
+			g_runner.target_precision * 100.0,
+			g_runner.point_time_budget
+		);
+	}
+	printf("\n");
+}
+
+void open_output(Runner_Output* output, const Sort_Kernel* kernel, const char* suffix, const Runner_Column* columns, size_t columns_count) {
+	const char* pivot_strategy = "";
+	if ((kernel->flags & SORTKERNEL_PIVOT_STRATEGY) && sorts_pivot_strategy() != PIVOTSTRATEGY_DEFAULT) {
+		pivot_strategy = pivotstrategy_name(sorts_pivot_strategy());
+	}
+	char small_sort[32] = "";
+	if ((kernel->flags & SORTKERNEL_SMALL_SORT) && sorts_small_sort() != SMALLSORT_DEFAULT) {
+		snprintf(small_sort, sizeof(small_sort), "%s%zu", smallsort_name(sorts_small_sort()), sorts_small_sort_cutoff());
+	}
+	const char* distribution = "";
+	if (g_runner.distribution != RUNNERDISTRIBUTION_UNIFORM) {
+		distribution = runnerdistribution_name(g_runner.distribution);
+	}
+	const char* element_type = "";
+	if (g_runner.element_type != ELEMENTTYPE_INT64) {
+		element_type = elementtype_name(g_runner.element_type);
+	}
+
+	char path[512];
+	int path_length = snprintf(path, sizeof(path), RUNNER_RESULTS_DIRECTORY "/%s%s%s%s%s%s%s%s%s%s%s",
+		kernel->name,
+		pivot_strategy[0] != '\0' ? "." : "",
+		pivot_strategy,
+		small_sort[0] != '\0' ? "." : "",
+		small_sort,
+		distribution[0] != '\0' ? "." : "",
+		distribution,
+		element_type[0] != '\0' ? "." : "",
+		element_type,
+		suffix,
+		g_runner.output_format == RUNNEROUTPUTFORMAT_BINARY ? RUNNER_BINARY_EXTENSION : RUNNER_CSV_EXTENSION
+	);
+	assert(path_length > 0 && (size_t)path_length < sizeof(path));
+
+	output->open = true;
+	output->columns = columns;
+	output->columns_count = columns_count;
+
+	switch (g_runner.output_format) {
+	case RUNNEROUTPUTFORMAT_CSV:
+		output->csv_file = fopen(path, "w");
+		assert(output->csv_file != NULL);
+		break;
+	case RUNNEROUTPUTFORMAT_BINARY: {
+		char metadata[RUNNER_METADATA_CAPACITY];
+		snprintf(metadata, sizeof(metadata), "%s", g_runner.metadata);
+		runner_metadata_append(metadata, sizeof(metadata), "kernel", kernel->name);
+		runner_metadata_append(metadata, sizeof(metadata), "kernel_name", kernel->display_name);
+		runner_metadata_append(metadata, sizeof(metadata), "pivot", (kernel->flags & SORTKERNEL_PIVOT_STRATEGY) ? pivotstrategy_name(sorts_pivot_strategy()) : "default");
+		if ((kernel->flags & SORTKERNEL_SMALL_SORT) && sorts_small_sort() != SMALLSORT_DEFAULT) {
+			runner_metadata_append(metadata, sizeof(metadata), "small_sort", smallsort_name(sorts_small_sort()));
+			char value[32];
+			snprintf(value, sizeof(value), "%zu", sorts_small_sort_cutoff());
+			runner_metadata_append(metadata, sizeof(metadata), "small_sort_cutoff", value);
+		} else {
+			runner_metadata_append(metadata, sizeof(metadata), "small_sort", "default");
+		}
+		runner_metadata_append(metadata, sizeof(metadata), "distribution", runnerdistribution_name(g_runner.distribution));
+		runner_metadata_append(metadata, sizeof(metadata), "element_type", elementtype_name(g_runner.element_type));
+		// The suffix without its leading dot, such as array_length.samples
+		runner_metadata_append(metadata, sizeof(metadata), "table", suffix + 1);
+
+		bool created = runnerresults_create(&output->results, path, columns, columns_count, metadata);
+		assert(created);
+		break;
+	}
+	default:
+		assert(false);
+	}
+}
+
+void write_output_row(Runner_Output* output, const Runner_Value* values) {
+	switch (g_runner.output_format) {
+	case RUNNEROUTPUTFORMAT_CSV:
+		runner_write_csv_row(output->csv_file, output->columns, output->columns_count, values);
+		fflush(output->csv_file);
+		break;
+	case RUNNEROUTPUTFORMAT_BINARY:
+		runnerresults_append(&output->results, values);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+void close_output(Runner_Output* output) {
+	if (!output->open) {
+		return;
+	}
+
+	switch (g_runner.output_format) {
+	case RUNNEROUTPUTFORMAT_CSV:
+		fclose(output->csv_file); break;
+	case RUNNEROUTPUTFORMAT_BINARY:
+		runnerresults_close(&output->results); break;
+	default:
+		assert(false);
+	}
+	output->open = false;
+}
+
+// The function sorting the current element type, NULL when it is int64_t and
+// kernel->function is used directly
+Typed_Sort_Function kernel_typed_function(const Sort_Kernel* kernel) {
+	if (g_runner.element_type == ELEMENTTYPE_INT64) {
+		return NULL;
+	}
+
+	assert(kernel->flags & SORTKERNEL_ELEMENT_TYPES);
+	return kernel->typed_functions[g_runner.element_type];
+}
+
+typedef struct {
+	double total_duration; // wall time of the whole measurement
+	double kernel_duration; // the part of total_duration attributed to the kernel
+	size_t sorted_arrays;
+	double harness_overhead; // per sort, still part of kernel_duration
+} Runner_Measurement;
+
+// Generates every array right before sorting it, timing both, and subtracts
+// the estimated generation time (the original measurement)
+void measure_kernel_subtracting_init(Runner_Worker* worker, const Sort_Kernel* kernel, size_t array_length, int64_t minimum_element, int64_t maximum_element, double min_execution_time, Runner_Measurement* measurement) {
+	Typed_Sort_Function typed_function = kernel_typed_function(kernel);
+	double total_duration = 0.0;
+	size_t sorted_arrays = 0;
+	struct timespec start;
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	do {
+		generate_typed_array(
+			worker,
+			g_runner.distribution,
+			g_runner.element_type,
+			worker->array_buffer,
+			array_length,
+			minimum_element,
+			maximum_element
+		);
+		runnercounters_start(&worker->counters);
+		if (typed_function != NULL) {
+			typed_function(worker->array_buffer, array_length);
+		} else {
+			kernel->function(worker->array_buffer, array_length);
+		}
+		runnercounters_stop(&worker->counters);
+
+		sorted_arrays += 1;
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		total_duration = timespec_duration(start, end);
+	} while(total_duration < min_execution_time);
+
+	double init_duration = g_runner.array_average_init_time[g_runner.distribution][g_runner.element_type] * (double)array_length * (double)sorted_arrays;
+
+	measurement->total_duration = total_duration;
+	measurement->kernel_duration = total_duration - init_duration;
+	measurement->sorted_arrays = sorted_arrays;
+	measurement->harness_overhead = NAN;
+}
+
+size_t calculate_batch_size(Runner_Worker* worker, size_t array_length) {
+	if (array_length == 0) {
+		return RUNNER_INPUT_POOL_MAX_ARRAYS;
+	}
+
+	size_t batch_size = worker->input_pool_capacity / array_length;
+	if (batch_size > RUNNER_INPUT_POOL_MAX_ARRAYS) {
+		batch_size = RUNNER_INPUT_POOL_MAX_ARRAYS;
+	}
+
+	return batch_size;
+}
+
+// Generates a pool of arrays once, then repeatedly copies it in the array
+// buffer and sorts all of its arrays between two timestamps, so that neither
+// the generation nor the copy are timed
+void measure_kernel_with_input_pool(Runner_Worker* worker, const Sort_Kernel* kernel, size_t array_length, int64_t minimum_element, int64_t maximum_element, double min_execution_time, Runner_Measurement* measurement) {
+	size_t batch_size = calculate_batch_size(worker, array_length);
+	assert(batch_size > 0);
+
+	// The arrays are packed one after the other whatever the element type, the
+	// last one may be generated as int64_t past the end of the others
+	Typed_Sort_Function typed_function = kernel_typed_function(kernel);
+	size_t array_size = array_length * elementtype_size(g_runner.element_type);
+	unsigned char* input_pool = (unsigned char*)worker->input_pool;
+	unsigned char* array_buffer = (unsigned char*)worker->array_buffer;
+	for (size_t i = 0; i < batch_size; i += 1) {
+		generate_typed_array(
+			worker,
+			g_runner.distribution,
+			g_runner.element_type,
+			input_pool + i * array_size,
+			array_length,
+			minimum_element,
+			maximum_element
+		);
+	}
+
+	double total_duration = 0.0;
+	double kernel_duration = 0.0;
+	size_t sorted_arrays = 0;
+	struct timespec measurement_start;
+	struct timespec start;
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &measurement_start);
+	do {
+		memcpy(array_buffer, input_pool, batch_size * array_size);
+
+		runnercounters_start(&worker->counters);
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		if (typed_function != NULL) {
+			for (size_t i = 0; i < batch_size; i += 1) {
+				typed_function(array_buffer + i * array_size, array_length);
+			}
+		} else {
+			for (size_t i = 0; i < batch_size; i += 1) {
+				kernel->function(worker->array_buffer + i * array_length, array_length);
+			}
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		runnercounters_stop(&worker->counters);
+
+		kernel_duration += timespec_duration(start, end);
+		sorted_arrays += batch_size;
+	} while(kernel_duration < min_execution_time);
+	total_duration = timespec_duration(measurement_start, end);
+
+	measurement->total_duration = total_duration;
+	measurement->kernel_duration = kernel_duration;
+	measurement->sorted_arrays = sorted_arrays;
+	measurement->harness_overhead = g_runner.call_overhead + g_runner.batch_overhead / (double)batch_size;
+}
+
+// Lays out the records of the given memory, count * (8 + payload_size) bytes
+void layout_records(Runner_Worker* worker, unsigned char* memory, size_t count, Record_Array* records) {
+	records->layout = worker->record_layout;
+	records->count = count;
+	records->payload_size = worker->payload_size;
+
+	records->records = memory;
+	records->keys = (int64_t*)memory;
+	records->payloads = memory + count * sizeof(int64_t);
+}
+
+// Generates the keys of the records in the array buffer, fills every payload
+// with the index of its record, and then sorts copies of them one at a time,
+// timing only the sorts, whatever the timing
+void measure_record_kernel(Runner_Worker* worker, const Sort_Kernel* kernel, size_t count, int64_t minimum_element, int64_t maximum_element, double min_execution_time, Runner_Measurement* measurement) {
+	assert(count <= worker->array_buffer_size);
+	assert(worker->payload_size % sizeof(uint64_t) == 0);
+
+	size_t records_size = count * (sizeof(int64_t) + worker->payload_size);
+	if (records_size > worker->record_buffer_capacity) {
+		free(worker->record_pool);
+		free(worker->record_buffer);
+		worker->record_pool = malloc(records_size);
+		worker->record_buffer = malloc(records_size);
+		assert(worker->record_pool != NULL && worker->record_buffer != NULL);
+		worker->record_buffer_capacity = records_size;
+	}
+
+	generate_array(worker, g_runner.distribution, worker->array_buffer, count, minimum_element, maximum_element);
+
+	Record_Array pool;
+	layout_records(worker, worker->record_pool, count, &pool);
+	for (size_t i = 0; i < count; i += 1) {
+		int64_t key = worker->array_buffer[i];
+		uint64_t index = i;
+
+		if (pool.layout == RECORDLAYOUT_AOS) {
+			memcpy(pool.records + i * recordarray_record_size(&pool), &key, sizeof(int64_t));
+		} else {
+			pool.keys[i] = key;
+		}
+		unsigned char* payload = (unsigned char*)recordarray_payload(&pool, i);
+		for (size_t j = 0; j < pool.payload_size; j += sizeof(uint64_t)) {
+			memcpy(payload + j, &index, sizeof(uint64_t));
+		}
+	}
+
+	double kernel_duration = 0.0;
+	size_t sorted_arrays = 0;
+	struct timespec measurement_start;
+	struct timespec start;
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &measurement_start);
+	do {
+		memcpy(worker->record_buffer, worker->record_pool, records_size);
+		Record_Array records;
+		layout_records(worker, worker->record_buffer, count, &records);
+
+		runnercounters_start(&worker->counters);
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		kernel->record_function(&records);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		runnercounters_stop(&worker->counters);
+
+		kernel_duration += timespec_duration(start, end);
+		sorted_arrays += 1;
+	} while(kernel_duration < min_execution_time);
+
+	measurement->total_duration = timespec_duration(measurement_start, end);
+	measurement->kernel_duration = kernel_duration;
+	measurement->sorted_arrays = sorted_arrays;
+	measurement->harness_overhead = NAN;
+}
+
+void measure_kernel(Runner_Worker* worker, const Sort_Kernel* kernel, size_t array_length, int64_t minimum_element, int64_t maximum_element, double min_execution_time, Runner_Measurement* measurement) {
+	if (kernel->flags & SORTKERNEL_RECORDS) {
+		measure_record_kernel(worker, kernel, array_length, minimum_element, maximum_element, min_execution_time, measurement);
+		return;
+	}
+
+	switch (g_runner.timing) {
+	case RUNNERTIMING_SUBTRACT_INIT:
+		measure_kernel_subtracting_init(worker, kernel, array_length, minimum_element, maximum_element, min_execution_time, measurement); break;
+	case RUNNERTIMING_INPUT_POOL:
+		measure_kernel_with_input_pool(worker, kernel, array_length, minimum_element, maximum_element, min_execution_time, measurement); break;
+	default:
+		abort();
+	}
+}
+
+// Whether the adaptive stopping rule is satisfied by the first count samples
+bool adaptive_precision_reached(const double* samples, size_t count) {
+	if (count < RUNNER_ADAPTIVE_MIN_SAMPLES) {
+		return false;
+	}
+
+	double sum = 0.0;
+	for (size_t i = 0; i < count; i += 1) {
+		sum += samples[i];
+	}
+	double mean = sum / (double)count;
+
+	double squares = 0.0;
+	for (size_t i = 0; i < count; i += 1) {
+		squares += (samples[i] - mean) * (samples[i] - mean);
+	}
+	double stddev = sqrt(squares / (double)(count - 1));
+
+	// Normal approximation of the confidence interval, cheaper than the
+	// bootstrap of the reported one
+	double half_width = RUNNER_ADAPTIVE_Z_SCORE * stddev / sqrt((double)count);
+	return half_width <= g_runner.target_precision * mean;
+}
+
+// Measures the samples of the point, and sums them in measurement. Without a
+// target precision exactly sample_count samples are measured, otherwise they
+// are measured until the target or the time budget of the point are reached.
+void measure_point(Runner_Worker* worker, const Sort_Kernel* kernel, size_t array_length, int64_t minimum_element, int64_t maximum_element, Runner_Point* point, Runner_Measurement* measurement) {
+	bool adaptive = g_runner.target_precision > 0.0;
+	size_t max_sample_count = adaptive ? RUNNER_ADAPTIVE_MAX_SAMPLES : g_runner.sample_count;
+	double min_execution_time = adaptive ? g_runner.min_sample_execution_time : g_runner.min_execution_time;
+
+	point->samples = malloc(sizeof(double) * max_sample_count);
+	point->sample_outliers = malloc(sizeof(bool) * max_sample_count);
+	assert(point->samples != NULL && point->sample_outliers != NULL);
+
+	measurement->total_duration = 0.0;
+	measurement->kernel_duration = 0.0;
+	measurement->sorted_arrays = 0;
+	measurement->harness_overhead = 0.0;
+
+	// The budget also covers what the measurements do not time, such as the
+	// generation of the input pool
+	struct timespec point_start;
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &point_start);
+
+	size_t sample_count = 0;
+	while (sample_count < max_sample_count) {
+		Runner_Measurement sample;
+		measure_kernel(worker, kernel, array_length, minimum_element, maximum_element, min_execution_time, &sample);
+
+		point->samples[sample_count] = sample.kernel_duration / (double)sample.sorted_arrays;
+		sample_count += 1;
+
+		measurement->total_duration += sample.total_duration;
+		measurement->kernel_duration += sample.kernel_duration;
+		measurement->sorted_arrays += sample.sorted_arrays;
+		measurement->harness_overhead += sample.harness_overhead * (double)sample.sorted_arrays;
+
+		if (adaptive) {
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			if (adaptive_precision_reached(point->samples, sample_count)
+				|| timespec_duration(point_start, now) >= g_runner.point_time_budget
+			) {
+				break;
+			}
+		}
+	}
+	measurement->harness_overhead /= (double)measurement->sorted_arrays;
+
+	runnersummary_compute(&point->summary, point->samples, sample_count, point->sample_outliers, &worker->random);
+}
+
+void print_summary(const Runner_Point* point) {
+	if (point->summary.count > 1) {
+		printf("\t-samples: %llu (%llu outliers)\n"
+			"\t-min/median/p95 time: %.17fs / %.17fs / %.17fs\n"
+			"\t-standard deviation: %.17fs\n"
+			"\t-%.0f%% confidence interval: [%.17fs, %.17fs] (+-%.3f%%)\n",
+			(unsigned long long)point->summary.count,
+			(unsigned long long)point->summary.outlier_count,
+			point->summary.min,
+			point->summary.median,
+			point->summary.p95,
+			point->summary.stddev,
+			RUNNER_CONFIDENCE_LEVEL * 100.0,
+			point->summary.ci_low,
+			point->summary.ci_high,
+			point->summary.relative_precision * 100.0
+		);
+	}
+}
+
+void print_counters(const Runner_Point* point) {
+	if (g_runner.counters_enabled) {
+		for (size_t i = 0; i < RUNNERCOUNTER_COUNT; i += 1) {
+			printf("\t-%s per sort: %.1f\n", runnercounter_name((Runner_Counter)i), point->counters[i]);
+		}
+	}
+	printf("\n");
+}
+
+// Measures one point of an axis, prints it under the given label and fills
+// point, x being its value on the axis
+void run_benchmark_point(Runner_Worker* worker, const Sort_Kernel* kernel, const char* label, uint64_t x, size_t array_length, int64_t minimum_element, int64_t maximum_element, Runner_Point* point) {
+	printf("Benchmarking %s...\n", label);
+
+	Sort_Stats* stats = sorts_stats();
+	sortstats_reset(stats);
+	runnercounters_reset(&worker->counters);
+
+	Runner_Measurement measurement;
+	measure_point(worker, kernel, array_length, minimum_element, maximum_element, point, &measurement);
+
+	double total_duration = measurement.total_duration;
+	double duration_without_init = measurement.kernel_duration;
+	size_t sorted_arrays = measurement.sorted_arrays;
+	double average_time = duration_without_init / (double)sorted_arrays;
+	double allocations_per_sort = (double)stats->allocation_count / (double)sorted_arrays;
+	runnercounters_read(&worker->counters, (double)sorted_arrays, point->counters);
+
+	printf("Benchmarked %s:\n"
+		"\t-total time: %.17fs (%.17fs without init)\n"
+		"\t-sorted arrays: %llu\n"
+		"\t-average time: %.17fs\n"
+		"\t-peak recursion depth: %llu\n"
+		"\t-allocations per sort: %.6f\n"
+		"\t-peak bytes: %llu\n",
+		label,
+		total_duration,
+		duration_without_init,
+		(unsigned long long)sorted_arrays,
+		average_time,
+		(unsigned long long)stats->peak_recursion_depth,
+		allocations_per_sort,
+		(unsigned long long)stats->peak_bytes
+	);
+	// The record kernels are not measured through the input pool
+	if (g_runner.timing == RUNNERTIMING_INPUT_POOL && !(kernel->flags & SORTKERNEL_RECORDS)) {
+		printf("\t-harness overhead per sort: %.17fs\n", measurement.harness_overhead);
+	}
+	print_summary(point);
+	print_counters(point);
+
+	point->x = x;
+	point->average_time = average_time;
+	point->peak_recursion_depth = stats->peak_recursion_depth;
+	point->allocations_per_sort = allocations_per_sort;
+	point->peak_bytes = stats->peak_bytes;
+	point->harness_overhead = measurement.harness_overhead;
+}
+
+void run_array_length_benchmark_iteration(Runner_Worker* worker, const Sort_Kernel* kernel, size_t iteration, Runner_Point* point) {
+	size_t array_length = calculate_array_length(iteration);
+
+	char label[RUNNER_POINT_LABEL_SIZE];
+	snprintf(label, sizeof(label), "array length iteration %llu (%llu elements)",
+		(unsigned long long)iteration + 1,
+		(unsigned long long)array_length
+	);
+
+	run_benchmark_point(worker, kernel, label, (uint64_t)array_length, array_length, RUNNER_MIN_ARRAY_ELEMENT, RUNNER_MAX_ARRAY_ELEMENT, point);
+}
+
+void run_input_range_benchmark_iteration(Runner_Worker* worker, const Sort_Kernel* kernel, size_t iteration, Runner_Point* point) {
+	int64_t input_range = calculate_input_range(iteration);
+	int64_t minimum_element = RUNNER_MIN_ARRAY_ELEMENT;
+	int64_t maximum_element = RUNNER_MIN_ARRAY_ELEMENT + input_range;
+
+	char label[RUNNER_POINT_LABEL_SIZE];
+	snprintf(label, sizeof(label), "input range iteration %llu (%llu input range: %llu-%llu)",
+		(unsigned long long)iteration + 1,
+		(unsigned long long)input_range,
+		(unsigned long long)minimum_element,
+		(unsigned long long)maximum_element
+	);
+
+	run_benchmark_point(worker, kernel, label, (uint64_t)input_range, RUNNER_ARRAY_LENGTH, minimum_element, maximum_element, point);
+}
+
+void run_thread_count_benchmark_iteration(Runner_Worker* worker, const Sort_Kernel* kernel, size_t iteration, Runner_Point* point) {
+	size_t thread_count = iteration + 1;
+	size_t array_length = RUNNER_THREAD_COUNT_ARRAY_LENGTH;
+
+	sorts_set_thread_count(thread_count);
+
+	char label[RUNNER_POINT_LABEL_SIZE];
+	snprintf(label, sizeof(label), "thread count iteration %llu (%llu threads, %llu elements)",
+		(unsigned long long)iteration + 1,
+		(unsigned long long)thread_count,
+		(unsigned long long)array_length
+	);
+
+	run_benchmark_point(worker, kernel, label, (uint64_t)thread_count, array_length, RUNNER_MIN_ARRAY_ELEMENT, RUNNER_MAX_ARRAY_ELEMENT, point);
+}
+
+void run_large_array_length_benchmark_iteration(Runner_Worker* worker, const Sort_Kernel* kernel, size_t iteration, Runner_Point* point) {
+	size_t array_length = calculate_large_array_length(iteration);
+
+	char label[RUNNER_POINT_LABEL_SIZE];
+	snprintf(label, sizeof(label), "large array length iteration %llu (%llu elements)",
+		(unsigned long long)iteration + 1,
+		(unsigned long long)array_length
+	);
+
+	run_benchmark_point(worker, kernel, label, (uint64_t)array_length, array_length, RUNNER_MIN_ARRAY_ELEMENT, RUNNER_MAX_ARRAY_ELEMENT, point);
+}
+
+void run_payload_size_benchmark_iteration(Runner_Worker* worker, const Sort_Kernel* kernel, Record_Layout layout, size_t iteration, Runner_Point* point) {
+	size_t payload_size = RUNNER_STARTING_PAYLOAD_SIZE + iteration * RUNNER_PAYLOAD_SIZE_STEP;
+	size_t array_length = RUNNER_PAYLOAD_ARRAY_LENGTH;
+
+	worker->record_layout = layout;
+	worker->payload_size = payload_size;
+
+	char label[RUNNER_POINT_LABEL_SIZE];
+	snprintf(label, sizeof(label), "payload size iteration %llu (%s, %llu bytes, %llu records)",
+		(unsigned long long)iteration + 1,
+		recordlayout_name(layout),
+		(unsigned long long)payload_size,
+		(unsigned long long)array_length
+	);
+
+	run_benchmark_point(worker, kernel, label, (uint64_t)payload_size, array_length, RUNNER_MIN_ARRAY_ELEMENT, RUNNER_MAX_ARRAY_ELEMENT, point);
+}
+
+typedef struct {
+	Runner_Axis axis;
+	size_t iteration;
+
+	Runner_Point point;
+	bool done;
+} Runner_Job;
+
+typedef struct {
+	const Sort_Kernel* kernel;
+
+	Runner_Job* jobs;
+	size_t jobs_count;
+	size_t next_job;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t job_done;
+} Runner_Sweep;
+
+static const char* g_axis_output_suffixes[RUNNERAXIS_COUNT] = {
+	RUNNER_ARRAY_LENGTH_OUTPUT_SUFFIX,
+	RUNNER_INPUT_RANGE_OUTPUT_SUFFIX,
+	RUNNER_THREAD_COUNT_OUTPUT_SUFFIX,
+	RUNNER_AOS_PAYLOAD_SIZE_OUTPUT_SUFFIX,
+	RUNNER_SOA_PAYLOAD_SIZE_OUTPUT_SUFFIX,
+	RUNNER_LARGE_ARRAY_LENGTH_OUTPUT_SUFFIX,
+};
+
+static const char* g_axis_samples_output_suffixes[RUNNERAXIS_COUNT] = {
+	RUNNER_ARRAY_LENGTH_SAMPLES_OUTPUT_SUFFIX,
+	RUNNER_INPUT_RANGE_SAMPLES_OUTPUT_SUFFIX,
+	RUNNER_THREAD_COUNT_SAMPLES_OUTPUT_SUFFIX,
+	RUNNER_AOS_PAYLOAD_SIZE_SAMPLES_OUTPUT_SUFFIX,
+	RUNNER_SOA_PAYLOAD_SIZE_SAMPLES_OUTPUT_SUFFIX,
+	RUNNER_LARGE_ARRAY_LENGTH_SAMPLES_OUTPUT_SUFFIX,
+};
+
+static const Runner_Column g_point_columns[] = {
+	{ "x",                    RUNNERCOLUMNTYPE_U64, 0 },
+	{ "average_time",         RUNNERCOLUMNTYPE_F64, 17 },
+	{ "peak_recursion_depth", RUNNERCOLUMNTYPE_U64, 0 },
+	{ "allocations_per_sort", RUNNERCOLUMNTYPE_F64, 6 },
+	{ "harness_overhead",     RUNNERCOLUMNTYPE_F64, 17 },
+	{ "seed",                 RUNNERCOLUMNTYPE_U64, 0 },
+	{ "cycles",               RUNNERCOLUMNTYPE_F64, 1 },
+	{ "instructions",         RUNNERCOLUMNTYPE_F64, 1 },
+	{ "branch_misses",        RUNNERCOLUMNTYPE_F64, 1 },
+	{ "l1d_misses",           RUNNERCOLUMNTYPE_F64, 1 },
+	{ "llc_misses",           RUNNERCOLUMNTYPE_F64, 1 },
+	{ "min_time",             RUNNERCOLUMNTYPE_F64, 17 },
+	{ "median_time",          RUNNERCOLUMNTYPE_F64, 17 },
+	{ "p95_time",             RUNNERCOLUMNTYPE_F64, 17 },
+	{ "stddev_time",          RUNNERCOLUMNTYPE_F64, 17 },
+	{ "ci_low",               RUNNERCOLUMNTYPE_F64, 17 },
+	{ "ci_high",              RUNNERCOLUMNTYPE_F64, 17 },
+	{ "outliers",             RUNNERCOLUMNTYPE_U64, 0 },
+	{ "samples",              RUNNERCOLUMNTYPE_U64, 0 },
+	{ "relative_precision",   RUNNERCOLUMNTYPE_F64, 6 },
+	{ "peak_bytes",           RUNNERCOLUMNTYPE_U64, 0 },
+};
+#define POINT_COLUMNS_COUNT (sizeof(g_point_columns) / sizeof(g_point_columns[0]))
+
+static const Runner_Column g_sample_columns[] = {
+	{ "x",       RUNNERCOLUMNTYPE_U64, 0 },
+	{ "sample",  RUNNERCOLUMNTYPE_U64, 0 },
+	{ "time",    RUNNERCOLUMNTYPE_F64, 17 },
+	{ "outlier", RUNNERCOLUMNTYPE_U64, 0 },
+};
+#define SAMPLE_COLUMNS_COUNT (sizeof(g_sample_columns) / sizeof(g_sample_columns[0]))
+
+void write_point(Runner_Output* output, const Runner_Point* point) {
+	Runner_Value values[POINT_COLUMNS_COUNT];
+	size_t i = 0;
+
+	values[i++].u64 = point->x;
+	values[i++].f64 = point->average_time;
+	values[i++].u64 = point->peak_recursion_depth;
+	values[i++].f64 = point->allocations_per_sort;
+	values[i++].f64 = point->harness_overhead;
+	values[i++].u64 = point->seed;
+	for (size_t j = 0; j < RUNNERCOUNTER_COUNT; j += 1) {
+		values[i++].f64 = point->counters[j];
+	}
+	values[i++].f64 = point->summary.min;
+	values[i++].f64 = point->summary.median;
+	values[i++].f64 = point->summary.p95;
+	values[i++].f64 = point->summary.stddev;
+	values[i++].f64 = point->summary.ci_low;
+	values[i++].f64 = point->summary.ci_high;
+	values[i++].u64 = point->summary.outlier_count;
+	values[i++].u64 = point->summary.count;
+	values[i++].f64 = point->summary.relative_precision;
+	values[i++].u64 = point->peak_bytes;
+	assert(i == POINT_COLUMNS_COUNT);
+
+	write_output_row(output, values);
+}
+
+// One row per sample: x, sample index, average time, 1 if it is an outlier
+void write_samples(Runner_Output* output, const Runner_Point* point) {
+	if (!output->open) {
+		return;
+	}
+
+	for (size_t i = 0; i < point->summary.count; i += 1) {
+		Runner_Value values[SAMPLE_COLUMNS_COUNT];
+		values[0].u64 = point->x;
+		values[1].u64 = i;
+		values[2].f64 = point->samples[i];
+		values[3].u64 = point->sample_outliers[i] ? 1 : 0;
+
+		write_output_row(output, values);
+	}
+}
+
+void run_job(Runner_Worker* worker, const Sort_Kernel* kernel, Runner_Job* job) {
+	runnerworker_seed(worker, job->axis, job->iteration);
+	job->point.seed = runner_point_seed(job->axis, job->iteration);
+	sorts_set_thread_scratch(&worker->scratch);
+	// perf_event_open counts the calling thread, so the counters are opened by
+	// the thread that runs the job. They would miss the work of the task pool,
+	// so the parallel kernels are written without counters.
+	if (g_runner.counters_enabled && !(kernel->flags & SORTKERNEL_PARALLEL)) {
+		runnercounters_open(&worker->counters);
+	}
+
+	switch (job->axis) {
+	case RUNNERAXIS_ARRAY_LENGTH:
+		run_array_length_benchmark_iteration(worker, kernel, job->iteration, &job->point); break;
+	case RUNNERAXIS_INPUT_RANGE:
+		run_input_range_benchmark_iteration(worker, kernel, job->iteration, &job->point); break;
+	case RUNNERAXIS_THREAD_COUNT:
+		run_thread_count_benchmark_iteration(worker, kernel, job->iteration, &job->point); break;
+	case RUNNERAXIS_AOS_PAYLOAD_SIZE:
+		run_payload_size_benchmark_iteration(worker, kernel, RECORDLAYOUT_AOS, job->iteration, &job->point); break;
+	case RUNNERAXIS_SOA_PAYLOAD_SIZE:
+		run_payload_size_benchmark_iteration(worker, kernel, RECORDLAYOUT_SOA, job->iteration, &job->point); break;
+	case RUNNERAXIS_LARGE_ARRAY_LENGTH:
+		run_large_array_length_benchmark_iteration(worker, kernel, job->iteration, &job->point); break;
+	default:
+		assert(false);
+	}
+
+	runnercounters_close(&worker->counters);
+	sorts_set_thread_scratch(NULL);
+}
+
+void write_job(Runner_Job* job) {
+	write_point(&g_runner.outputs[job->axis], &job->point);
+	write_samples(&g_runner.sample_outputs[job->axis], &job->point);
+
+	free(job->point.samples);
+	free(job->point.sample_outliers);
+}
+
+void add_jobs(Runner_Sweep* sweep, Runner_Axis axis, size_t iterations_count) {
+	for (size_t iteration = 0; iteration < iterations_count; iteration += 1) {
+		Runner_Job* job = &sweep->jobs[sweep->jobs_count];
+		job->axis = axis;
+		job->iteration = iteration;
+		job->done = false;
+
+		sweep->jobs_count += 1;
+	}
+}
+
+// Record kernels are swept over the payload size in both layouts, the others
+// over the array length and the input range
+void create_jobs(Runner_Sweep* sweep, const Sort_Kernel* kernel) {
+	sweep->kernel = kernel;
+	sweep->jobs_count = 0;
+	sweep->next_job = 0;
+
+	sweep->jobs = malloc(sizeof(Runner_Job) * 2 * (RUNNER_TEST_COUNT > RUNNER_PAYLOAD_SIZE_COUNT ? RUNNER_TEST_COUNT : RUNNER_PAYLOAD_SIZE_COUNT));
+	assert(sweep->jobs != NULL);
+
+	if (kernel->flags & SORTKERNEL_RECORDS) {
+		add_jobs(sweep, RUNNERAXIS_AOS_PAYLOAD_SIZE, RUNNER_PAYLOAD_SIZE_COUNT);
+		add_jobs(sweep, RUNNERAXIS_SOA_PAYLOAD_SIZE, RUNNER_PAYLOAD_SIZE_COUNT);
+	} else {
+		add_jobs(sweep, RUNNERAXIS_ARRAY_LENGTH, RUNNER_TEST_COUNT);
+		add_jobs(sweep, RUNNERAXIS_INPUT_RANGE, RUNNER_TEST_COUNT);
+	}
+}
+
+void run_benchmarks_sequential(Runner_Sweep* sweep) {
+	for (size_t i = 0; i < sweep->jobs_count; i += 1) {
+		run_job(&g_runner.workers[0], sweep->kernel, &sweep->jobs[i]);
+		write_job(&sweep->jobs[i]);
+	}
+}
+
+typedef struct {
+	Runner_Sweep* sweep;
+	Runner_Worker* worker;
+} Worker_Thread_Data;
+
+void* worker_thread(void* user_data) {
+	Worker_Thread_Data* data = user_data;
+	Runner_Sweep* sweep = data->sweep;
+
+	if (g_runner.pin_threads && !runner_pin_thread(data->worker->cpu)) {
+		fprintf(stderr, "Could not pin a worker to cpu %llu\n", (unsigned long long)data->worker->cpu);
+	}
+
+	for (;;) {
+		pthread_mutex_lock(&sweep->mutex);
+		size_t job_index = sweep->next_job;
+		sweep->next_job += 1;
+		pthread_mutex_unlock(&sweep->mutex);
+
+		if (job_index >= sweep->jobs_count) {
+			break;
+		}
+
+		run_job(data->worker, sweep->kernel, &sweep->jobs[job_index]);
+
+		pthread_mutex_lock(&sweep->mutex);
+		sweep->jobs[job_index].done = true;
+		pthread_cond_broadcast(&sweep->job_done);
+		pthread_mutex_unlock(&sweep->mutex);
+	}
+
+	return NULL;
+}
+
+void run_benchmarks_parallel(Runner_Sweep* sweep) {
+	pthread_mutex_init(&sweep->mutex, NULL);
+	pthread_cond_init(&sweep->job_done, NULL);
+
+	pthread_t* threads = malloc(sizeof(pthread_t) * g_runner.thread_count);
+	Worker_Thread_Data* threads_data = malloc(sizeof(Worker_Thread_Data) * g_runner.thread_count);
+	assert(threads != NULL && threads_data != NULL);
+
+	for (size_t i = 0; i < g_runner.thread_count; i += 1) {
+		threads_data[i].sweep = sweep;
+		threads_data[i].worker = &g_runner.workers[i];
+
+		int result = pthread_create(&threads[i], NULL, worker_thread, &threads_data[i]);
+		assert(result == 0);
+	}
+
+	// The points are written in order as soon as they and all the points
+	// before them are done, so that the csvs are identical to a sequential run
+	for (size_t i = 0; i < sweep->jobs_count; i += 1) {
+		pthread_mutex_lock(&sweep->mutex);
+		while (!sweep->jobs[i].done) {
+			pthread_cond_wait(&sweep->job_done, &sweep->mutex);
+		}
+		pthread_mutex_unlock(&sweep->mutex);
+
+		write_job(&sweep->jobs[i]);
+	}
+
+	for (size_t i = 0; i < g_runner.thread_count; i += 1) {
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+	free(threads_data);
+	pthread_cond_destroy(&sweep->job_done);
+	pthread_mutex_destroy(&sweep->mutex);
+}
+
+// Parallel kernels are always measured one point at a time: their calls all
+// go through the one shared task pool, which serializes them and whose threads
+// would compete with the other measuring threads
+void run_benchmarks(const Sort_Kernel* kernel) {
+	Runner_Sweep sweep;
+	create_jobs(&sweep, kernel);
+
+	if (g_runner.thread_count == 1 || (kernel->flags & SORTKERNEL_PARALLEL)) {
+		run_benchmarks_sequential(&sweep);
+	} else {
+		run_benchmarks_parallel(&sweep);
+	}
+
+	free(sweep.jobs);
+}
+
+// The thread count sweep is always measured on the calling thread, as the
+// kernel itself already uses all the cpus
+void run_thread_count_benchmarks(const Sort_Kernel* kernel) {
+	Runner_Worker worker;
+	runnerworker_create(&worker, g_runner.cpus[0], RUNNER_THREAD_COUNT_ARRAY_LENGTH);
+
+	for (size_t iteration = 0; iteration < g_runner.cpus_count; iteration += 1) {
+		Runner_Job job;
+		job.axis = RUNNERAXIS_THREAD_COUNT;
+		job.iteration = iteration;
+
+		run_job(&worker, kernel, &job);
+		write_job(&job);
+	}
+
+	sorts_set_thread_count(0);
+	runnerworker_destroy(&worker);
+}
+
+// Like the thread count sweep, the large arrays are sorted one at a time on the
+// calling thread, with every cpu available to parallel kernels
+void run_large_array_length_benchmarks(const Sort_Kernel* kernel) {
+	Runner_Worker worker;
+	runnerworker_create(&worker, g_runner.cpus[0], RUNNER_LARGE_ENDING_ARRAY_LENGTH);
+
+	sorts_set_thread_count(0);
+	for (size_t iteration = 0; iteration < RUNNER_LARGE_ARRAY_LENGTH_COUNT; iteration += 1) {
+		Runner_Job job;
+		job.axis = RUNNERAXIS_LARGE_ARRAY_LENGTH;
+		job.iteration = iteration;
+
+		run_job(&worker, kernel, &job);
+		write_job(&job);
+	}
+
+	runnerworker_destroy(&worker);
+}
+
+void open_axis_outputs(const Sort_Kernel* kernel, Runner_Axis axis) {
+	open_output(&g_runner.outputs[axis], kernel, g_axis_output_suffixes[axis], g_point_columns, POINT_COLUMNS_COUNT);
+	if (g_runner.write_samples) {
+		open_output(&g_runner.sample_outputs[axis], kernel, g_axis_samples_output_suffixes[axis], g_sample_columns, SAMPLE_COLUMNS_COUNT);
+	}
+}
+
+void close_axis_outputs(Runner_Axis axis) {
+	close_output(&g_runner.outputs[axis]);
+	close_output(&g_runner.sample_outputs[axis]);
+}
+
+void runner_benchmark_kernel(const Sort_Kernel* kernel, Runner_Distribution distribution, Element_Type element_type) {
+	g_runner.distribution = distribution;
+	g_runner.element_type = element_type;
+
+	if (kernel->flags & SORTKERNEL_RECORDS) {
+		open_axis_outputs(kernel, RUNNERAXIS_AOS_PAYLOAD_SIZE);
+		open_axis_outputs(kernel, RUNNERAXIS_SOA_PAYLOAD_SIZE);
+	} else {
+		open_axis_outputs(kernel, RUNNERAXIS_ARRAY_LENGTH);
+		open_axis_outputs(kernel, RUNNERAXIS_INPUT_RANGE);
+	}
+
+	char small_sort[32] = "default";
+	if ((kernel->flags & SORTKERNEL_SMALL_SORT) && sorts_small_sort() != SMALLSORT_DEFAULT) {
+		snprintf(small_sort, sizeof(small_sort), "%s (%zu)", smallsort_name(sorts_small_sort()), sorts_small_sort_cutoff());
+	}
+	printf("Benchmarking algorithm %s (%s pivot, %s leaf sort, %s input, %s elements)...\n\n",
+		kernel->display_name,
+		(kernel->flags & SORTKERNEL_PIVOT_STRATEGY) ? pivotstrategy_name(sorts_pivot_strategy()) : "default",
+		small_sort,
+		runnerdistribution_name(distribution),
+		elementtype_name(element_type)
+	);
+	run_benchmarks(kernel);
+	if (kernel->flags & SORTKERNEL_PARALLEL) {
+		open_axis_outputs(kernel, RUNNERAXIS_THREAD_COUNT);
+		run_thread_count_benchmarks(kernel);
+		close_axis_outputs(RUNNERAXIS_THREAD_COUNT);
+	}
+	if (g_runner.large_array_lengths && !(kernel->flags & SORTKERNEL_RECORDS)) {
+		open_axis_outputs(kernel, RUNNERAXIS_LARGE_ARRAY_LENGTH);
+		run_large_array_length_benchmarks(kernel);
+		close_axis_outputs(RUNNERAXIS_LARGE_ARRAY_LENGTH);
+	}
+	printf("Benchmark of %s finished!\n\n", kernel->display_name);
+
+	for (size_t i = 0; i < RUNNERAXIS_COUNT; i += 1) {
+		close_axis_outputs((Runner_Axis)i);
+	}
+}
+
+void runner_terminate(void) {
+	for (size_t i = 0; i < g_runner.thread_count; i += 1) {
+		runnerworker_destroy(&g_runner.workers[i]);
+	}
+	free(g_runner.workers);
+
+	sorts_terminate();
+}
@@ -0,0 +1,198 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "harness/runner.h"
+
+static const char* g_counter_names[RUNNERCOUNTER_COUNT] = {
+	"cycles",
+	"instructions",
+	"branch_misses",
+	"l1d_misses",
+	"llc_misses",
+};
+
+const char* runnercounter_name(Runner_Counter counter) {
+	return g_counter_names[counter];
+}
+
+#ifdef __linux__
+
+static void fill_counter_attributes(Runner_Counter counter, struct perf_event_attr* attributes) {
+	memset(attributes, 0, sizeof(*attributes));
+	attributes->size = sizeof(*attributes);
+	attributes->disabled = 1;
+	attributes->exclude_kernel = 1;
+	attributes->exclude_hv = 1;
+	attributes->read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	switch (counter) {
+	case RUNNERCOUNTER_CYCLES:
+		attributes->type = PERF_TYPE_HARDWARE;
+		attributes->config = PERF_COUNT_HW_CPU_CYCLES;
+		break;
+	case RUNNERCOUNTER_INSTRUCTIONS:
+		attributes->type = PERF_TYPE_HARDWARE;
+		attributes->config = PERF_COUNT_HW_INSTRUCTIONS;
+		break;
+	case RUNNERCOUNTER_BRANCH_MISSES:
+		attributes->type = PERF_TYPE_HARDWARE;
+		attributes->config = PERF_COUNT_HW_BRANCH_MISSES;
+		break;
+	case RUNNERCOUNTER_L1D_MISSES:
+		attributes->type = PERF_TYPE_HW_CACHE;
+		attributes->config = PERF_COUNT_HW_CACHE_L1D
+			| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+			| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		break;
+	case RUNNERCOUNTER_LLC_MISSES:
+		attributes->type = PERF_TYPE_HW_CACHE;
+		attributes->config = PERF_COUNT_HW_CACHE_LL
+			| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+			| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		break;
+	default:
+		break;
+	}
+}
+
+bool runnercounters_open(Runner_Counters* counters) {
+	counters->group_descriptor = -1;
+
+	// The first counter that opens leads the group, so that all of them are
+	// enabled, disabled and read together. Counters the cpu or the kernel do
+	// not support are left out.
+	for (size_t i = 0; i < RUNNERCOUNTER_COUNT; i += 1) {
+		struct perf_event_attr attributes;
+		fill_counter_attributes((Runner_Counter)i, &attributes);
+
+		counters->descriptors[i] = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, counters->group_descriptor, 0);
+		counters->ids[i] = 0;
+		if (counters->descriptors[i] < 0) {
+			continue;
+		}
+
+		if (ioctl(counters->descriptors[i], PERF_EVENT_IOC_ID, &counters->ids[i]) != 0) {
+			close(counters->descriptors[i]);
+			counters->descriptors[i] = -1;
+			continue;
+		}
+		if (counters->group_descriptor < 0) {
+			counters->group_descriptor = counters->descriptors[i];
+		}
+	}
+
+	return counters->group_descriptor >= 0;
+}
+
+void runnercounters_close(Runner_Counters* counters) {
+	// The leader is closed last, as it is also the first one opened
+	for (size_t ii = RUNNERCOUNTER_COUNT; ii > 0; ii -= 1) {
+		size_t i = ii - 1;
+		if (counters->descriptors[i] >= 0) {
+			close(counters->descriptors[i]);
+			counters->descriptors[i] = -1;
+		}
+	}
+	counters->group_descriptor = -1;
+}
+
+void runnercounters_reset(Runner_Counters* counters) {
+	if (counters->group_descriptor >= 0) {
+		ioctl(counters->group_descriptor, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+void runnercounters_start(Runner_Counters* counters) {
+	if (counters->group_descriptor >= 0) {
+		ioctl(counters->group_descriptor, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+void runnercounters_stop(Runner_Counters* counters) {
+	if (counters->group_descriptor >= 0) {
+		ioctl(counters->group_descriptor, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+void runnercounters_read(Runner_Counters* counters, double divisor, double* values) {
+	for (size_t i = 0; i < RUNNERCOUNTER_COUNT; i += 1) {
+		values[i] = NAN;
+	}
+	if (counters->group_descriptor < 0) {
+		return;
+	}
+
+	// nr, time_enabled, time_running, then a (value, id) pair per counter
+	uint64_t data[3 + 2 * RUNNERCOUNTER_COUNT];
+	if (read(counters->group_descriptor, data, sizeof(data)) < (ssize_t)(3 * sizeof(uint64_t))) {
+		return;
+	}
+
+	uint64_t time_enabled = data[1];
+	uint64_t time_running = data[2];
+	if (time_running == 0) {
+		return;
+	}
+	// The group was multiplexed with other events, scaled to the whole time
+	double scale = (double)time_enabled / (double)time_running;
+
+	for (uint64_t j = 0; j < data[0] && j < RUNNERCOUNTER_COUNT; j += 1) {
+		uint64_t value = data[3 + 2 * j];
+		uint64_t id = data[3 + 2 * j + 1];
+
+		for (size_t i = 0; i < RUNNERCOUNTER_COUNT; i += 1) {
+			if (counters->descriptors[i] >= 0 && counters->ids[i] == id) {
+				values[i] = (double)value * scale / divisor;
+			}
+		}
+	}
+}
+
+#else
+
+bool runnercounters_open(Runner_Counters* counters) {
+	counters->group_descriptor = -1;
+	for (size_t i = 0; i < RUNNERCOUNTER_COUNT; i += 1) {
+		counters->descriptors[i] = -1;
+		counters->ids[i] = 0;
+	}
+
+	return false;
+}
+
+void runnercounters_close(Runner_Counters* counters) {
+	(void)counters;
+}
+
+void runnercounters_reset(Runner_Counters* counters) {
+	(void)counters;
+}
+
+void runnercounters_start(Runner_Counters* counters) {
+	(void)counters;
+}
+
+void runnercounters_stop(Runner_Counters* counters) {
+	(void)counters;
+}
+
+void runnercounters_read(Runner_Counters* counters, double divisor, double* values) {
+	(void)counters;
+	(void)divisor;
+	for (size_t i = 0; i < RUNNERCOUNTER_COUNT; i += 1) {
+		values[i] = NAN;
+	}
+}
+
+#endif
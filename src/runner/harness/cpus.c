@@ -0,0 +1,131 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
+
+#include "harness/runner.h"
+
+#ifdef __linux__
+
+static bool read_cpu_topology_value(size_t cpu, const char* value_name, long* value) {
+	char path[256];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%llu/topology/%s",
+		(unsigned long long)cpu,
+		value_name
+	);
+
+	FILE* file = fopen(path, "r");
+	if (file == NULL) {
+		return false;
+	}
+
+	bool success = fscanf(file, "%ld", value) == 1;
+	fclose(file);
+
+	return success;
+}
+
+size_t runner_list_cpus(size_t* cpus, size_t cpus_capacity, bool physical_only) {
+	cpu_set_t allowed_cpus;
+	if (sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) != 0) {
+		cpus[0] = 0;
+		return 1;
+	}
+
+	// (package, core) of every cpu already listed, used to skip the SMT
+	// siblings of a core when listing physical cores only
+	static long listed_packages[RUNNER_MAX_THREADS];
+	static long listed_cores[RUNNER_MAX_THREADS];
+
+	size_t cpus_count = 0;
+	for (size_t cpu = 0; cpu < CPU_SETSIZE && cpus_count < cpus_capacity; cpu += 1) {
+		if (!CPU_ISSET(cpu, &allowed_cpus)) {
+			continue;
+		}
+
+		long package;
+		long core;
+		if (physical_only
+			&& read_cpu_topology_value(cpu, "physical_package_id", &package)
+			&& read_cpu_topology_value(cpu, "core_id", &core)
+		) {
+			bool is_sibling = false;
+			for (size_t i = 0; i < cpus_count; i += 1) {
+				if (listed_packages[i] == package && listed_cores[i] == core) {
+					is_sibling = true;
+					break;
+				}
+			}
+			if (is_sibling) {
+				continue;
+			}
+		} else {
+			package = -1;
+			core = (long)cpu;
+		}
+
+		listed_packages[cpus_count] = package;
+		listed_cores[cpus_count] = core;
+		cpus[cpus_count] = cpu;
+		cpus_count += 1;
+	}
+
+	return cpus_count;
+}
+
+bool runner_pin_thread(size_t cpu) {
+	cpu_set_t cpu_set;
+	CPU_ZERO(&cpu_set);
+	CPU_SET(cpu, &cpu_set);
+
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+#else
+
+size_t runner_list_cpus(size_t* cpus, size_t cpus_capacity, bool physical_only) {
+	long cpus_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+#ifdef __APPLE__
+	if (physical_only) {
+		int physical_cpus_count;
+		size_t value_size = sizeof(physical_cpus_count);
+		if (sysctlbyname("hw.physicalcpu", &physical_cpus_count, &value_size, NULL, 0) == 0) {
+			cpus_count = physical_cpus_count;
+		}
+	}
+#else
+	(void)physical_only;
+#endif
+
+	if (cpus_count < 1) {
+		cpus_count = 1;
+	}
+	if ((size_t)cpus_count > cpus_capacity) {
+		cpus_count = (long)cpus_capacity;
+	}
+
+	for (long i = 0; i < cpus_count; i += 1) {
+		cpus[i] = (size_t)i;
+	}
+
+	return (size_t)cpus_count;
+}
+
+bool runner_pin_thread(size_t cpu) {
+	(void)cpu;
+	return false;
+}
+
+#endif
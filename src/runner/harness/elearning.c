@@ -0,0 +1,336 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "sorts/scan.h"
+#include "harness/runner.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ELEARNING_X86 1
+#include <immintrin.h>
+#endif
+
+// Bytes classified at once by the tokenizer, one bit each in a uint64_t
+#define ELEARNING_WINDOW 64
+// Readable bytes the tokenizer needs past the end of its text: the rest of the
+// last window, the byte after it and a whole 8 byte load
+#define ELEARNING_PADDING (ELEARNING_WINDOW + 8)
+// Longest int64_t with its sign and the separator after it
+#define ELEARNING_MAX_NUMBER_LENGTH 21
+
+typedef void (*Elearning_Classify_Function)(const unsigned char* window, uint64_t* digits, uint64_t* minuses);
+
+typedef struct {
+	int64_t* numbers;
+	size_t numbers_count;
+	size_t numbers_capacity;
+} Elearning_Numbers;
+
+static const uint64_t g_powers_of_10[9] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+};
+
+static const char g_digit_pairs[201] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static bool elearning_is_digit(unsigned char byte) {
+	return (unsigned char)(byte - '0') < 10;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CLASSIFICATION
+////////////////////////////////////////////////////////////////////////////////
+
+// Sets bit i of digits if window[i] is a decimal digit, and of minuses if it is
+// a minus sign
+static void classify_scalar(const unsigned char* window, uint64_t* digits, uint64_t* minuses) {
+	*digits = 0;
+	*minuses = 0;
+	for (size_t i = 0; i < ELEARNING_WINDOW; i += 1) {
+		*digits |= (uint64_t)elearning_is_digit(window[i]) << i;
+		*minuses |= (uint64_t)(window[i] == '-') << i;
+	}
+}
+
+#ifdef ELEARNING_X86
+__attribute__((target("sse4.2")))
+static void classify_sse42(const unsigned char* window, uint64_t* digits, uint64_t* minuses) {
+	__m128i zero = _mm_set1_epi8('0');
+	__m128i nine = _mm_set1_epi8(9);
+	__m128i minus = _mm_set1_epi8('-');
+
+	*digits = 0;
+	*minuses = 0;
+	for (size_t i = 0; i < ELEARNING_WINDOW; i += 16) {
+		__m128i bytes = _mm_loadu_si128((const __m128i*)&window[i]);
+		// Digits are the bytes that stay at most 9 after subtracting '0'
+		__m128i values = _mm_sub_epi8(bytes, zero);
+		__m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(values, nine), values);
+
+		*digits |= (uint64_t)(uint16_t)_mm_movemask_epi8(is_digit) << i;
+		*minuses |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, minus)) << i;
+	}
+}
+
+__attribute__((target("avx2")))
+static void classify_avx2(const unsigned char* window, uint64_t* digits, uint64_t* minuses) {
+	__m256i zero = _mm256_set1_epi8('0');
+	__m256i nine = _mm256_set1_epi8(9);
+	__m256i minus = _mm256_set1_epi8('-');
+
+	*digits = 0;
+	*minuses = 0;
+	for (size_t i = 0; i < ELEARNING_WINDOW; i += 32) {
+		__m256i bytes = _mm256_loadu_si256((const __m256i*)&window[i]);
+		__m256i values = _mm256_sub_epi8(bytes, zero);
+		__m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(values, nine), values);
+
+		*digits |= (uint64_t)(uint32_t)_mm256_movemask_epi8(is_digit) << i;
+		*minuses |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, minus)) << i;
+	}
+}
+#endif
+
+// AVX-512F has no byte comparisons, the AVX2 version serves it too
+static const Elearning_Classify_Function g_classify_functions[SCANISA_COUNT] = {
+	classify_scalar,
+#ifdef ELEARNING_X86
+	classify_sse42,
+	classify_avx2,
+	classify_avx2,
+#endif
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PARSING
+////////////////////////////////////////////////////////////////////////////////
+
+// Parses the number at token, an optional minus sign followed by at least one
+// digit, 8 digits at a time. Returns its length.
+static size_t parse_number(const unsigned char* token, int64_t* number) {
+	const unsigned char* cursor = token;
+	bool negative = *cursor == '-';
+	cursor += negative;
+
+	uint64_t value = 0;
+	bool overflow = false;
+	for (;;) {
+		uint64_t bytes;
+		memcpy(&bytes, cursor, sizeof(bytes));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		bytes = __builtin_bswap64(bytes);
+#endif
+
+		// The first byte of the string is the lowest one. A byte is a digit if
+		// subtracting '0' does not borrow and adding 0x46 does not reach 0x80;
+		// the carries only reach the bytes after the first non digit.
+		uint64_t values = bytes - 0x3030303030303030ULL;
+		uint64_t non_digits = (values | (bytes + 0x4646464646464646ULL)) & 0x8080808080808080ULL;
+		size_t digit_count = non_digits == 0 ? 8 : (size_t)__builtin_ctzll(non_digits) / 8;
+		if (digit_count == 0) {
+			break;
+		}
+
+		// Moved to the top, so that the missing digits become leading zeros,
+		// then combined in pairs, quadruplets and octets
+		values <<= 8 * (8 - digit_count);
+		values = ((values & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+		values = ((values & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+		values = ((values & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+
+		overflow |= __builtin_mul_overflow(value, g_powers_of_10[digit_count], &value);
+		overflow |= __builtin_add_overflow(value, values, &value);
+		cursor += digit_count;
+		if (digit_count < 8) {
+			break;
+		}
+	}
+
+	overflow |= value > (negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX);
+	assert(!overflow);
+	(void)overflow;
+
+	*number = negative ? (int64_t)(0 - value) : (int64_t)value;
+	return (size_t)(cursor - token);
+}
+
+static void reserve_numbers(Elearning_Numbers* numbers, size_t count) {
+	if (numbers->numbers_count + count <= numbers->numbers_capacity) {
+		return;
+	}
+
+	while (numbers->numbers_count + count > numbers->numbers_capacity) {
+		numbers->numbers_capacity *= 2;
+	}
+	numbers->numbers = realloc(numbers->numbers, numbers->numbers_capacity * sizeof(int64_t));
+	assert(numbers->numbers != NULL);
+}
+
+// Appends the numbers of text[0..text_length - 1]: every longest sequence of
+// digits, with the minus sign right before it. The last byte must not belong
+// to a number, and ELEARNING_PADDING bytes after the text must be readable.
+static void tokenize(Elearning_Classify_Function classify, const unsigned char* text, size_t text_length, Elearning_Numbers* numbers) {
+	uint64_t previous_digits = 0;
+	uint64_t previous_minus_starts = 0;
+	for (size_t window = 0; window < text_length; window += ELEARNING_WINDOW) {
+		// Numbers start at most every other byte, but for a one digit number
+		// followed right away by the minus of the next one, as in "1-1-1"
+		reserve_numbers(numbers, ELEARNING_WINDOW / 2 + 1);
+
+		uint64_t digits;
+		uint64_t minuses;
+		classify(text + window, &digits, &minuses);
+
+		// Numbers start at a minus followed by a digit, or at a digit that
+		// follows neither a digit nor such a minus
+		uint64_t next_digit = elearning_is_digit(text[window + ELEARNING_WINDOW]);
+		uint64_t minus_starts = minuses & ((digits >> 1) | (next_digit << 63));
+		uint64_t follows = (digits << 1) | (previous_digits >> 63) | (minus_starts << 1) | (previous_minus_starts >> 63);
+		uint64_t starts = minus_starts | (digits & ~follows);
+		if (text_length - window < ELEARNING_WINDOW) {
+			starts &= (1ULL << (text_length - window)) - 1;
+		}
+
+		while (starts != 0) {
+			size_t start = window + (size_t)__builtin_ctzll(starts);
+			parse_number(text + start, &numbers->numbers[numbers->numbers_count]);
+			numbers->numbers_count += 1;
+
+			starts &= starts - 1;
+		}
+
+		previous_digits = digits;
+		previous_minus_starts = minus_starts;
+	}
+}
+
+// Reads the first line of stdin in blocks, parsing every block up to its last
+// separator and keeping the number cut by the end of the block for the next
+// one, so that neither the line nor the numbers are limited in length.
+static void read_numbers(Elearning_Numbers* numbers) {
+	Elearning_Classify_Function classify = g_classify_functions[scan_isa()];
+
+	unsigned char* buffer = malloc(RUNNER_ELEARNING_BLOCK_SIZE + ELEARNING_PADDING);
+	assert(buffer != NULL);
+	memset(buffer, 0, RUNNER_ELEARNING_BLOCK_SIZE + ELEARNING_PADDING);
+
+	size_t buffer_length = 0;
+	for (;;) {
+		// One byte is left for the separator after the last number
+		assert(buffer_length < RUNNER_ELEARNING_BLOCK_SIZE - 1);
+		ssize_t read_size = read(STDIN_FILENO, buffer + buffer_length, RUNNER_ELEARNING_BLOCK_SIZE - 1 - buffer_length);
+		if (read_size < 0 && errno == EINTR) {
+			continue;
+		}
+		assert(read_size >= 0);
+
+		unsigned char* newline = memchr(buffer + buffer_length, '\n', (size_t)read_size);
+		if (read_size == 0 || newline != NULL) {
+			buffer_length = newline != NULL ? (size_t)(newline - buffer) : buffer_length;
+			buffer[buffer_length] = ' ';
+			tokenize(classify, buffer, buffer_length + 1, numbers);
+			break;
+		}
+		buffer_length += (size_t)read_size;
+
+		size_t text_length = buffer_length;
+		while (text_length > 0 && (elearning_is_digit(buffer[text_length - 1]) || buffer[text_length - 1] == '-')) {
+			text_length -= 1;
+		}
+		tokenize(classify, buffer, text_length, numbers);
+
+		buffer_length -= text_length;
+		memmove(buffer, buffer + text_length, buffer_length);
+	}
+
+	free(buffer);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// FORMATTING
+////////////////////////////////////////////////////////////////////////////////
+
+// Writes number followed by a space, two digits at a time. Returns the end.
+static char* format_number(char* output, int64_t number) {
+	uint64_t value = (uint64_t)number;
+	if (number < 0) {
+		*output = '-';
+		output += 1;
+		value = 0 - value;
+	}
+
+	char digits[20];
+	char* end = digits + sizeof(digits);
+	char* cursor = end;
+	while (value >= 100) {
+		cursor -= 2;
+		memcpy(cursor, &g_digit_pairs[(value % 100) * 2], 2);
+		value /= 100;
+	}
+	if (value >= 10) {
+		cursor -= 2;
+		memcpy(cursor, &g_digit_pairs[value * 2], 2);
+	} else {
+		cursor -= 1;
+		*cursor = (char)('0' + value);
+	}
+
+	memcpy(output, cursor, (size_t)(end - cursor));
+	output += end - cursor;
+	*output = ' ';
+	return output + 1;
+}
+
+static void write_numbers(const int64_t* numbers, size_t numbers_count) {
+	char* buffer = malloc(RUNNER_ELEARNING_BLOCK_SIZE);
+	assert(buffer != NULL);
+
+	char* cursor = buffer;
+	for (size_t i = 0; i < numbers_count; i += 1) {
+		// Leaves room for the newline too
+		if (cursor + ELEARNING_MAX_NUMBER_LENGTH + 1 > buffer + RUNNER_ELEARNING_BLOCK_SIZE) {
+			fwrite(buffer, 1, (size_t)(cursor - buffer), stdout);
+			cursor = buffer;
+		}
+
+		cursor = format_number(cursor, numbers[i]);
+	}
+	*cursor = '\n';
+	cursor += 1;
+
+	fwrite(buffer, 1, (size_t)(cursor - buffer), stdout);
+	fflush(stdout);
+	free(buffer);
+}
+
+void run_elearning_mode(const Sort_Kernel* kernel) {
+	Elearning_Numbers numbers;
+	numbers.numbers_capacity = 512;
+	numbers.numbers_count = 0;
+	numbers.numbers = malloc(numbers.numbers_capacity * sizeof(int64_t));
+	assert(numbers.numbers != NULL);
+
+	read_numbers(&numbers);
+
+	if (numbers.numbers_count > 0) {
+		kernel->function(numbers.numbers, numbers.numbers_count);
+	}
+	assert(is_array_sorted(numbers.numbers, numbers.numbers_count));
+
+	write_numbers(numbers.numbers, numbers.numbers_count);
+
+	free(numbers.numbers);
+}
@@ -0,0 +1,473 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "sorts/task_pool.h"
+#include "sorts/loser_tree.h"
+#include "harness/runner.h"
+
+// Sorted run in a runs file, in elements from the start of the file
+typedef struct {
+	uint64_t start;
+	uint64_t length;
+} External_Run;
+
+typedef struct {
+	double io_time;
+	double sort_time;
+	double merge_time;
+	uint64_t bytes_read;
+	uint64_t bytes_written;
+} External_Stats;
+
+static double elapsed_seconds(struct timespec start) {
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	return (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1000000000.0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// I/O
+////////////////////////////////////////////////////////////////////////////////
+
+// Reads length elements from the given element of the file, in as few calls as
+// the system allows
+static bool external_read(int file, int64_t* elements, uint64_t start, size_t length, External_Stats* stats) {
+	struct timespec begin;
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+
+	unsigned char* bytes = (unsigned char*)elements;
+	size_t size = length * sizeof(int64_t);
+	off_t offset = (off_t)(start * sizeof(int64_t));
+	while (size > 0) {
+		ssize_t read_size = pread(file, bytes, size, offset);
+		if (read_size < 0 && errno == EINTR) {
+			continue;
+		}
+		if (read_size <= 0) {
+			fprintf(stderr, "Could not read: %s\n", read_size < 0 ? strerror(errno) : "unexpected end of file");
+			return false;
+		}
+
+		bytes += read_size;
+		size -= (size_t)read_size;
+		offset += read_size;
+	}
+
+	stats->io_time += elapsed_seconds(begin);
+	stats->bytes_read += length * sizeof(int64_t);
+	return true;
+}
+
+static bool external_write(int file, const int64_t* elements, uint64_t start, size_t length, External_Stats* stats) {
+	struct timespec begin;
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+
+	const unsigned char* bytes = (const unsigned char*)elements;
+	size_t size = length * sizeof(int64_t);
+	off_t offset = (off_t)(start * sizeof(int64_t));
+	while (size > 0) {
+		ssize_t written_size = pwrite(file, bytes, size, offset);
+		if (written_size < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written_size < 0) {
+			fprintf(stderr, "Could not write: %s\n", strerror(errno));
+			return false;
+		}
+
+		bytes += written_size;
+		size -= (size_t)written_size;
+		offset += written_size;
+	}
+
+	stats->io_time += elapsed_seconds(begin);
+	stats->bytes_written += length * sizeof(int64_t);
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// RUN FORMATION
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	const Sort_Kernel* kernel;
+	int64_t* chunk;
+	size_t chunk_length;
+	size_t part_count;
+} External_Chunk_Sort;
+
+static size_t external_part_start(const External_Chunk_Sort* sort, size_t index) {
+	return sort->chunk_length * index / sort->part_count;
+}
+
+static void external_sort_part(Task_Pool* pool, size_t worker_index, Task task) {
+	(void)pool;
+	(void)worker_index;
+
+	External_Chunk_Sort* sort = task.user_data;
+	size_t start = external_part_start(sort, task.index);
+	size_t end = external_part_start(sort, task.index + 1);
+
+	sort->kernel->function(sort->chunk + start, end - start);
+}
+
+static void external_sort_root(Task_Pool* pool, size_t worker_index, Task task) {
+	External_Chunk_Sort* sort = task.user_data;
+
+	for (size_t i = 1; i < sort->part_count; i += 1) {
+		Task spawned = task;
+		spawned.function = external_sort_part;
+		spawned.index = i;
+
+		taskpool_spawn(pool, worker_index, spawned);
+	}
+
+	external_sort_part(pool, worker_index, task);
+}
+
+// Sorts every part of the chunk on its own thread, each becoming a run
+static void external_sort_chunk(External_Chunk_Sort* sort) {
+	if (sort->part_count == 1) {
+		sort->kernel->function(sort->chunk, sort->chunk_length);
+		return;
+	}
+
+	Task root;
+	root.function = external_sort_root;
+	root.array = sort->chunk;
+	root.array_length = sort->chunk_length;
+	root.depth = 0;
+	root.index = 0;
+	root.user_data = sort;
+
+	taskpool_run(sorts_task_pool(), root);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MERGE
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	int input;
+	const External_Run* runs;
+	size_t run_count;
+	// One block per run, then the output block
+	int64_t* memory;
+	size_t block_length;
+
+	// Next element of every run still in the file, and how many are left
+	uint64_t* next;
+	uint64_t* remaining;
+} External_Merge;
+
+static bool external_refill(External_Merge* merge, Loser_Tree* tree, size_t run, External_Stats* stats) {
+	int64_t* block = merge->memory + run * merge->block_length;
+	size_t length = merge->block_length;
+	if (length > merge->remaining[run]) {
+		length = (size_t)merge->remaining[run];
+	}
+
+	if (!external_read(merge->input, block, merge->next[run], length, stats)) {
+		return false;
+	}
+
+	merge->next[run] += length;
+	merge->remaining[run] -= length;
+	tree->heads[run] = block;
+	tree->ends[run] = block + length;
+	return true;
+}
+
+// Merges runs[0..run_count - 1] of the input into one run written at the
+// given element of the output
+static bool external_merge_runs(External_Merge* merge, int output, uint64_t output_start, External_Stats* stats) {
+	struct timespec begin;
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+	double io_time = stats->io_time;
+
+	Loser_Tree tree;
+	losertree_create(&tree, merge->run_count);
+
+	bool success = true;
+	for (size_t run = 0; run < merge->run_count && success; run += 1) {
+		merge->next[run] = merge->runs[run].start;
+		merge->remaining[run] = merge->runs[run].length;
+		success = external_refill(merge, &tree, run, stats);
+	}
+	losertree_build(&tree);
+
+	int64_t* output_block = merge->memory + merge->run_count * merge->block_length;
+	size_t output_length = 0;
+	while (success && !losertree_empty(&tree)) {
+		size_t winner = tree.winner;
+		output_block[output_length] = *tree.heads[winner];
+		output_length += 1;
+
+		tree.heads[winner] += 1;
+		if (tree.heads[winner] == tree.ends[winner] && merge->remaining[winner] > 0) {
+			success = external_refill(merge, &tree, winner, stats);
+		}
+		losertree_replay(&tree, winner);
+
+		if (output_length == merge->block_length) {
+			success = success && external_write(output, output_block, output_start, output_length, stats);
+			output_start += output_length;
+			output_length = 0;
+		}
+	}
+	if (success && output_length > 0) {
+		success = external_write(output, output_block, output_start, output_length, stats);
+	}
+
+	losertree_destroy(&tree);
+
+	stats->merge_time += elapsed_seconds(begin) - (stats->io_time - io_time);
+	return success;
+}
+
+// Merges the runs in groups of at most fan_in, from the input file to the
+// output one at the same offsets, as the runs of a group are contiguous.
+// Afterwards runs describes the merged runs.
+static bool external_merge_pass(int input, int output, External_Run* runs, size_t* run_count, size_t fan_in, int64_t* memory, size_t memory_length, External_Stats* stats) {
+	uint64_t* positions = malloc(2 * fan_in * sizeof(uint64_t));
+	assert(positions != NULL);
+
+	External_Merge merge;
+	merge.input = input;
+	merge.memory = memory;
+	merge.next = positions;
+	merge.remaining = positions + fan_in;
+
+	bool success = true;
+	size_t merged_count = 0;
+	for (size_t first = 0; first < *run_count && success; first += fan_in) {
+		merge.runs = &runs[first];
+		merge.run_count = *run_count - first < fan_in ? *run_count - first : fan_in;
+		merge.block_length = memory_length / (merge.run_count + 1);
+
+		success = external_merge_runs(&merge, output, runs[first].start, stats);
+
+		External_Run merged;
+		merged.start = runs[first].start;
+		merged.length = 0;
+		for (size_t run = 0; run < merge.run_count; run += 1) {
+			merged.length += runs[first + run].length;
+		}
+		runs[merged_count] = merged;
+		merged_count += 1;
+	}
+
+	free(positions);
+	*run_count = merged_count;
+	return success;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// EXTERNAL SORT
+////////////////////////////////////////////////////////////////////////////////
+
+static char* external_path(const char* path, const char* suffix) {
+	size_t size = strlen(path) + strlen(suffix) + 1;
+	char* result = malloc(size);
+	assert(result != NULL);
+	snprintf(result, size, "%s%s", path, suffix);
+
+	return result;
+}
+
+static int external_open(const char* path, int flags) {
+	int file = open(path, flags, 0644);
+	if (file < 0) {
+		fprintf(stderr, "Could not open %s: %s\n", path, strerror(errno));
+	}
+
+	return file;
+}
+
+bool run_external_mode(const Sort_Kernel* kernel, const Runner_External_Options* options) {
+	char* output_path = options->output_path != NULL
+		? external_path(options->output_path, "")
+		: external_path(options->input_path, RUNNER_EXTERNAL_OUTPUT_SUFFIX);
+	char* runs_paths[2] = {
+		external_path(output_path, RUNNER_EXTERNAL_RUNS_SUFFIX),
+		external_path(output_path, RUNNER_EXTERNAL_MERGED_RUNS_SUFFIX),
+	};
+
+	size_t memory_length = options->memory_budget / sizeof(int64_t);
+	size_t min_block_length = RUNNER_EXTERNAL_MIN_BLOCK_SIZE / sizeof(int64_t);
+	// At least two runs and the output in blocks of the smallest size
+	size_t fan_in = memory_length / min_block_length - 1;
+	bool valid = true;
+	if (memory_length / min_block_length < 3) {
+		fprintf(stderr, "The memory budget must be at least %llu bytes\n", (unsigned long long)(3 * RUNNER_EXTERNAL_MIN_BLOCK_SIZE));
+		valid = false;
+	}
+	if (strcmp(output_path, options->input_path) == 0) {
+		fprintf(stderr, "The output must not overwrite the input\n");
+		valid = false;
+	}
+	if (!valid) {
+		free(output_path);
+		free(runs_paths[0]);
+		free(runs_paths[1]);
+		return false;
+	}
+
+	struct timespec begin;
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+
+	int input = external_open(options->input_path, O_RDONLY);
+	struct stat input_stat;
+	if (input >= 0 && fstat(input, &input_stat) != 0) {
+		fprintf(stderr, "Could not read %s: %s\n", options->input_path, strerror(errno));
+		close(input);
+		input = -1;
+	}
+	if (input >= 0 && input_stat.st_size % sizeof(int64_t) != 0) {
+		fprintf(stderr, "%s is not made of 8 byte integers\n", options->input_path);
+		close(input);
+		input = -1;
+	}
+	if (input < 0) {
+		free(output_path);
+		free(runs_paths[0]);
+		free(runs_paths[1]);
+		return false;
+	}
+	posix_fadvise(input, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	uint64_t array_length = (uint64_t)input_stat.st_size / sizeof(int64_t);
+	size_t chunk_length = memory_length;
+	size_t chunk_count = (size_t)((array_length + chunk_length - 1) / chunk_length);
+	// Parallel kernels sort a whole chunk with all their threads. An input of
+	// a single chunk is sorted at once and written straight to the output.
+	size_t part_count = 1;
+	if (!(kernel->flags & SORTKERNEL_PARALLEL) && chunk_count > 1) {
+		part_count = sorts_thread_count();
+	}
+
+	int output = external_open(output_path, O_WRONLY | O_CREAT | O_TRUNC);
+	int runs_files[2] = { -1, -1 };
+	if (chunk_count > 1) {
+		runs_files[0] = external_open(runs_paths[0], O_RDWR | O_CREAT | O_TRUNC);
+	}
+
+	int64_t* memory = malloc(memory_length * sizeof(int64_t));
+	External_Run* runs = malloc((chunk_count * part_count + 1) * sizeof(External_Run));
+	assert(memory != NULL && runs != NULL);
+	size_t run_count = 0;
+
+	External_Stats stats;
+	memset(&stats, 0, sizeof(stats));
+
+	bool success = output >= 0 && (chunk_count <= 1 || runs_files[0] >= 0);
+	int spill = chunk_count > 1 ? runs_files[0] : output;
+	for (uint64_t chunk_start = 0; chunk_start < array_length && success; chunk_start += chunk_length) {
+		External_Chunk_Sort sort;
+		sort.kernel = kernel;
+		sort.chunk = memory;
+		sort.chunk_length = array_length - chunk_start < chunk_length ? (size_t)(array_length - chunk_start) : chunk_length;
+		sort.part_count = part_count < sort.chunk_length ? part_count : 1;
+
+		success = external_read(input, sort.chunk, chunk_start, sort.chunk_length, &stats);
+		if (!success) {
+			break;
+		}
+
+		struct timespec sort_begin;
+		clock_gettime(CLOCK_MONOTONIC, &sort_begin);
+		external_sort_chunk(&sort);
+		stats.sort_time += elapsed_seconds(sort_begin);
+
+		for (size_t part = 0; part < sort.part_count; part += 1) {
+			size_t start = external_part_start(&sort, part);
+			size_t end = external_part_start(&sort, part + 1);
+			assert(is_array_sorted(sort.chunk + start, end - start));
+
+			runs[run_count].start = chunk_start + start;
+			runs[run_count].length = end - start;
+			run_count += 1;
+		}
+
+		success = external_write(spill, sort.chunk, chunk_start, sort.chunk_length, &stats);
+	}
+
+	// Every pass but the last one merges from one runs file to the other
+	size_t formed_run_count = run_count;
+	size_t pass_count = 0;
+	size_t current = 0;
+	while (success && run_count > fan_in) {
+		if (runs_files[1 - current] < 0) {
+			runs_files[1 - current] = external_open(runs_paths[1 - current], O_RDWR | O_CREAT | O_TRUNC);
+			if (runs_files[1 - current] < 0) {
+				success = false;
+				break;
+			}
+		}
+
+		success = external_merge_pass(runs_files[current], runs_files[1 - current], runs, &run_count, fan_in, memory, memory_length, &stats);
+		pass_count += 1;
+		current = 1 - current;
+	}
+	if (success && chunk_count > 1) {
+		success = external_merge_pass(runs_files[current], output, runs, &run_count, fan_in, memory, memory_length, &stats);
+		pass_count += 1;
+	}
+
+	double total_time = elapsed_seconds(begin);
+
+	free(memory);
+	free(runs);
+	close(input);
+	if (output >= 0) {
+		close(output);
+	}
+	for (size_t i = 0; i < 2; i += 1) {
+		if (runs_files[i] >= 0) {
+			close(runs_files[i]);
+			unlink(runs_paths[i]);
+		}
+	}
+
+	if (success) {
+		printf("Sorted %llu elements of %s with %s into %s:\n"
+			"\t-runs: %llu, merge passes: %llu\n"
+			"\t-total time: %.6fs\n"
+			"\t-I/O time: %.6fs (%llu bytes read, %llu bytes written)\n"
+			"\t-CPU time: %.6fs (%.6fs sorting the runs, %.6fs merging)\n",
+			(unsigned long long)array_length,
+			options->input_path,
+			kernel->display_name,
+			output_path,
+			(unsigned long long)formed_run_count,
+			(unsigned long long)pass_count,
+			total_time,
+			stats.io_time,
+			(unsigned long long)stats.bytes_read,
+			(unsigned long long)stats.bytes_written,
+			stats.sort_time + stats.merge_time,
+			stats.sort_time,
+			stats.merge_time
+		);
+	}
+
+	free(output_path);
+	free(runs_paths[0]);
+	free(runs_paths[1]);
+	return success;
+}
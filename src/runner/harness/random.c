@@ -0,0 +1,205 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include "harness/runner.h"
+
+static const char* g_generator_names[RUNNERGENERATOR_COUNT] = {
+	"xoshiro",
+	"pcg",
+};
+
+const char* runnergenerator_name(Runner_Generator generator) {
+	return g_generator_names[generator];
+}
+
+bool runnergenerator_parse(const char* name, Runner_Generator* generator) {
+	for (size_t i = 0; i < RUNNERGENERATOR_COUNT; i += 1) {
+		if (strcmp(g_generator_names[i], name) == 0) {
+			*generator = (Runner_Generator)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Used to expand a seed into a full state, as recommended for both generators
+static uint64_t splitmix64(uint64_t* state) {
+	*state += 0x9E3779B97F4A7C15ULL;
+
+	uint64_t result = *state;
+	result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	result = (result ^ (result >> 27)) * 0x94D049BB133111EBULL;
+	return result ^ (result >> 31);
+}
+
+static uint64_t rotate_left(uint64_t value, unsigned shift) {
+	return (value << shift) | (value >> (64 - shift));
+}
+
+static uint32_t rotate_right32(uint32_t value, unsigned shift) {
+	return (value >> shift) | (value << ((32 - shift) & 31));
+}
+
+// xoshiro256** by Blackman and Vigna
+static uint64_t xoshiro256_next(uint64_t* state) {
+	uint64_t result = rotate_left(state[1] * 5, 7) * 9;
+	uint64_t t = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotate_left(state[3], 45);
+
+	return result;
+}
+
+// PCG-XSH-RR 64/32 by O'Neill, state[0] is the state and state[1] the
+// (odd) increment. Two outputs make a 64 bit number.
+static uint32_t pcg32_next(uint64_t* state) {
+	uint64_t old_state = state[0];
+	state[0] = old_state * 6364136223846793005ULL + state[1];
+
+	uint32_t xorshifted = (uint32_t)(((old_state >> 18) ^ old_state) >> 27);
+	return rotate_right32(xorshifted, (unsigned)(old_state >> 59));
+}
+
+void runnerrandom_seed(Runner_Random* random, Runner_Generator generator, uint64_t seed) {
+	random->generator = generator;
+
+	uint64_t seed_state = seed;
+	for (size_t i = 0; i < 4; i += 1) {
+		random->state[i] = splitmix64(&seed_state);
+	}
+
+	if (generator == RUNNERGENERATOR_PCG) {
+		random->state[1] |= 1;
+	}
+}
+
+uint64_t runnerrandom_next(Runner_Random* random) {
+	switch (random->generator) {
+	case RUNNERGENERATOR_XOSHIRO:
+		return xoshiro256_next(random->state);
+	case RUNNERGENERATOR_PCG: {
+		uint64_t high = pcg32_next(random->state);
+		return (high << 32) | pcg32_next(random->state);
+	}
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+// Maps value in [0, 2^64) to [0, bound) with Lemire's multiply and shift. Sets
+// *rejected when value falls in the biased part of the range, and a new one
+// has to be drawn.
+static uint64_t bounded_from(uint64_t value, uint64_t bound, bool* rejected) {
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 product = (unsigned __int128)value * bound;
+	uint64_t low = (uint64_t)product;
+
+	*rejected = false;
+	if (low < bound) {
+		uint64_t threshold = (0 - bound) % bound;
+		*rejected = low < threshold;
+	}
+
+	return (uint64_t)(product >> 64);
+#else
+	// Plain rejection of the incomplete last interval
+	uint64_t threshold = (0 - bound) % bound;
+	*rejected = value < threshold;
+
+	return value % bound;
+#endif
+}
+
+uint64_t runnerrandom_bounded(Runner_Random* random, uint64_t bound) {
+	assert(bound > 0);
+
+	bool rejected;
+	uint64_t result;
+	do {
+		result = bounded_from(runnerrandom_next(random), bound, &rejected);
+	} while (rejected);
+
+	return result;
+}
+
+// RUNNER_RANDOM_LANES independent xoshiro256** streams, seeded from the
+// generator, stepped together with their states interleaved so that the loop
+// can be vectorized by the compiler
+static void xoshiro256_fill_lanes(Runner_Random* random, uint64_t* values, size_t count) {
+	uint64_t s0[RUNNER_RANDOM_LANES];
+	uint64_t s1[RUNNER_RANDOM_LANES];
+	uint64_t s2[RUNNER_RANDOM_LANES];
+	uint64_t s3[RUNNER_RANDOM_LANES];
+
+	uint64_t seed_state = xoshiro256_next(random->state);
+	for (size_t lane = 0; lane < RUNNER_RANDOM_LANES; lane += 1) {
+		s0[lane] = splitmix64(&seed_state);
+		s1[lane] = splitmix64(&seed_state);
+		s2[lane] = splitmix64(&seed_state);
+		s3[lane] = splitmix64(&seed_state);
+	}
+
+	size_t i = 0;
+	for (; i + RUNNER_RANDOM_LANES <= count; i += RUNNER_RANDOM_LANES) {
+		for (size_t lane = 0; lane < RUNNER_RANDOM_LANES; lane += 1) {
+			uint64_t result = rotate_left(s1[lane] * 5, 7) * 9;
+			uint64_t t = s1[lane] << 17;
+
+			s2[lane] ^= s0[lane];
+			s3[lane] ^= s1[lane];
+			s1[lane] ^= s2[lane];
+			s0[lane] ^= s3[lane];
+			s2[lane] ^= t;
+			s3[lane] = rotate_left(s3[lane], 45);
+
+			values[i + lane] = result;
+		}
+	}
+	for (; i < count; i += 1) {
+		values[i] = xoshiro256_next(random->state);
+	}
+}
+
+void runnerrandom_fill(Runner_Random* random, int64_t* array, size_t array_length, int64_t minimum_element, int64_t maximum_element) {
+	assert(minimum_element <= maximum_element);
+
+	// The raw 64 bit values are written in the array itself, then mapped to
+	// the range in place
+	uint64_t* values = (uint64_t*)array;
+	switch (random->generator) {
+	case RUNNERGENERATOR_XOSHIRO:
+		xoshiro256_fill_lanes(random, values, array_length);
+		break;
+	default:
+		for (size_t i = 0; i < array_length; i += 1) {
+			values[i] = runnerrandom_next(random);
+		}
+		break;
+	}
+
+	uint64_t range = (uint64_t)maximum_element - (uint64_t)minimum_element;
+	if (range == UINT64_MAX) {
+		return;
+	}
+
+	uint64_t bound = range + 1;
+	for (size_t i = 0; i < array_length; i += 1) {
+		bool rejected;
+		uint64_t offset = bounded_from(values[i], bound, &rejected);
+		if (rejected) {
+			offset = runnerrandom_bounded(random, bound);
+		}
+
+		array[i] = (int64_t)((uint64_t)minimum_element + offset);
+	}
+}
@@ -0,0 +1,325 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <sys/utsname.h>
+
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
+
+#include "harness/runner.h"
+
+// Filled in by CMake
+#ifndef SORTBENCH_GIT_COMMIT
+#define SORTBENCH_GIT_COMMIT "unknown"
+#endif
+#ifndef SORTBENCH_C_FLAGS
+#define SORTBENCH_C_FLAGS "unknown"
+#endif
+#ifndef SORTBENCH_BUILD_TYPE
+#define SORTBENCH_BUILD_TYPE "unknown"
+#endif
+
+static const char g_results_magic[8] = { 'S', 'O', 'R', 'T', 'B', 'E', 'N', 'C' };
+
+static const char* g_output_format_names[RUNNEROUTPUTFORMAT_COUNT] = {
+	"csv",
+	"binary",
+};
+
+const char* runneroutputformat_name(Runner_Output_Format format) {
+	return g_output_format_names[format];
+}
+
+bool runneroutputformat_parse(const char* name, Runner_Output_Format* format) {
+	for (size_t i = 0; i < RUNNEROUTPUTFORMAT_COUNT; i += 1) {
+		if (strcmp(g_output_format_names[i], name) == 0) {
+			*format = (Runner_Output_Format)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// METADATA
+////////////////////////////////////////////////////////////////////////////////
+
+static void read_cpu_model(char* model, size_t model_capacity) {
+	snprintf(model, model_capacity, "unknown");
+
+#ifdef __APPLE__
+	size_t length = model_capacity;
+	if (sysctlbyname("machdep.cpu.brand_string", model, &length, NULL, 0) != 0) {
+		snprintf(model, model_capacity, "unknown");
+	}
+#else
+	FILE* file = fopen("/proc/cpuinfo", "r");
+	if (file == NULL) {
+		return;
+	}
+
+	char line[512];
+	while (fgets(line, sizeof(line), file) != NULL) {
+		// "model name" on x86, "Model" or "Hardware" on some arm boards
+		if (strncmp(line, "model name", 10) == 0 || strncmp(line, "Model", 5) == 0 || strncmp(line, "Hardware", 8) == 0) {
+			char* value = strchr(line, ':');
+			if (value == NULL) {
+				continue;
+			}
+			value += 1;
+			while (*value == ' ' || *value == '\t') {
+				value += 1;
+			}
+			value[strcspn(value, "\n")] = '\0';
+
+			snprintf(model, model_capacity, "%s", value);
+			break;
+		}
+	}
+	fclose(file);
+#endif
+}
+
+static const char* compiler_description(void) {
+#if defined(__clang__)
+	return "clang " __clang_version__;
+#elif defined(__GNUC__)
+	return "gcc " __VERSION__;
+#else
+	return "unknown";
+#endif
+}
+
+void runner_metadata_append(char* metadata, size_t metadata_capacity, const char* key, const char* value) {
+	size_t length = strlen(metadata);
+	assert(length < metadata_capacity);
+
+	int written = snprintf(metadata + length, metadata_capacity - length, "%s=%s\n", key, value);
+	assert(written > 0 && (size_t)written < metadata_capacity - length);
+}
+
+void runner_metadata_collect(char* metadata, size_t metadata_capacity) {
+	metadata[0] = '\0';
+
+	char value[256];
+	struct utsname system;
+	if (uname(&system) == 0) {
+		runner_metadata_append(metadata, metadata_capacity, "os", system.sysname);
+		runner_metadata_append(metadata, metadata_capacity, "os_release", system.release);
+		runner_metadata_append(metadata, metadata_capacity, "arch", system.machine);
+		runner_metadata_append(metadata, metadata_capacity, "host", system.nodename);
+	}
+
+	read_cpu_model(value, sizeof(value));
+	runner_metadata_append(metadata, metadata_capacity, "cpu", value);
+	runner_metadata_append(metadata, metadata_capacity, "compiler", compiler_description());
+	runner_metadata_append(metadata, metadata_capacity, "build_type", SORTBENCH_BUILD_TYPE);
+	runner_metadata_append(metadata, metadata_capacity, "c_flags", SORTBENCH_C_FLAGS);
+	runner_metadata_append(metadata, metadata_capacity, "commit", SORTBENCH_GIT_COMMIT);
+
+	time_t now = time(NULL);
+	struct tm date;
+	if (gmtime_r(&now, &date) != NULL && strftime(value, sizeof(value), "%Y-%m-%dT%H:%M:%SZ", &date) > 0) {
+		runner_metadata_append(metadata, metadata_capacity, "date", value);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CSV ROWS
+////////////////////////////////////////////////////////////////////////////////
+
+void runner_write_csv_row(FILE* file, const Runner_Column* columns, size_t columns_count, const Runner_Value* values) {
+	for (size_t i = 0; i < columns_count; i += 1) {
+		const char* separator = i > 0 ? ", " : "";
+
+		switch (columns[i].type) {
+		case RUNNERCOLUMNTYPE_U64:
+			fprintf(file, "%s%llu", separator, (unsigned long long)values[i].u64); break;
+		case RUNNERCOLUMNTYPE_F64:
+			fprintf(file, "%s%.*f", separator, (int)columns[i].precision, values[i].f64); break;
+		default:
+			assert(false);
+		}
+	}
+	fprintf(file, "\n");
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// BINARY RESULTS
+////////////////////////////////////////////////////////////////////////////////
+
+// Everything is stored little endian, whatever the machine
+static void encode_u64(unsigned char* bytes, uint64_t value) {
+	for (size_t i = 0; i < 8; i += 1) {
+		bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+}
+
+static uint64_t decode_u64(const unsigned char* bytes) {
+	uint64_t value = 0;
+	for (size_t i = 0; i < 8; i += 1) {
+		value |= (uint64_t)bytes[i] << (8 * i);
+	}
+	return value;
+}
+
+static void write_u32(FILE* file, uint32_t value) {
+	unsigned char bytes[4] = {
+		(unsigned char)value,
+		(unsigned char)(value >> 8),
+		(unsigned char)(value >> 16),
+		(unsigned char)(value >> 24),
+	};
+	fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static bool read_u32(FILE* file, uint32_t* value) {
+	unsigned char bytes[4];
+	if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) {
+		return false;
+	}
+
+	*value = (uint32_t)bytes[0]
+		| ((uint32_t)bytes[1] << 8)
+		| ((uint32_t)bytes[2] << 16)
+		| ((uint32_t)bytes[3] << 24);
+	return true;
+}
+
+bool runnerresults_create(Runner_Results* results, const char* path, const Runner_Column* columns, size_t columns_count, const char* metadata) {
+	assert(columns_count <= RUNNER_RESULTS_MAX_COLUMNS);
+
+	results->file = fopen(path, "wb");
+	if (results->file == NULL) {
+		return false;
+	}
+	// Rows are only written out in big blocks, so that logging every sample
+	// does not cost a system call each
+	setvbuf(results->file, NULL, _IOFBF, RUNNER_RESULTS_BUFFER_SIZE);
+
+	results->columns_count = columns_count;
+	memcpy(results->columns, columns, sizeof(Runner_Column) * columns_count);
+	results->metadata = NULL;
+
+	fwrite(g_results_magic, 1, sizeof(g_results_magic), results->file);
+	write_u32(results->file, RUNNER_RESULTS_VERSION);
+
+	size_t metadata_length = strlen(metadata);
+	write_u32(results->file, (uint32_t)metadata_length);
+	fwrite(metadata, 1, metadata_length, results->file);
+
+	write_u32(results->file, (uint32_t)columns_count);
+	for (size_t i = 0; i < columns_count; i += 1) {
+		size_t name_length = strlen(columns[i].name);
+		assert(name_length < RUNNER_RESULTS_MAX_COLUMN_NAME);
+
+		unsigned char description[4] = {
+			(unsigned char)columns[i].type,
+			(unsigned char)columns[i].precision,
+			(unsigned char)name_length,
+			0,
+		};
+		fwrite(description, 1, sizeof(description), results->file);
+		fwrite(columns[i].name, 1, name_length, results->file);
+	}
+
+	return !ferror(results->file);
+}
+
+void runnerresults_append(Runner_Results* results, const Runner_Value* values) {
+	unsigned char row[RUNNER_RESULTS_MAX_COLUMNS * 8];
+	for (size_t i = 0; i < results->columns_count; i += 1) {
+		// Doubles are stored through their bit pattern
+		uint64_t bits = values[i].u64;
+		encode_u64(row + i * 8, bits);
+	}
+
+	fwrite(row, 8, results->columns_count, results->file);
+}
+
+bool runnerresults_open(Runner_Results* results, const char* path) {
+	results->file = fopen(path, "rb");
+	results->metadata = NULL;
+	if (results->file == NULL) {
+		return false;
+	}
+
+	char magic[sizeof(g_results_magic)];
+	uint32_t version;
+	uint32_t metadata_length;
+	if (fread(magic, 1, sizeof(magic), results->file) != sizeof(magic)
+		|| memcmp(magic, g_results_magic, sizeof(magic)) != 0
+		|| !read_u32(results->file, &version)
+		|| version != RUNNER_RESULTS_VERSION
+		|| !read_u32(results->file, &metadata_length)
+	) {
+		runnerresults_close(results);
+		return false;
+	}
+
+	results->metadata = malloc(metadata_length + 1);
+	assert(results->metadata != NULL);
+	if (fread(results->metadata, 1, metadata_length, results->file) != metadata_length) {
+		runnerresults_close(results);
+		return false;
+	}
+	results->metadata[metadata_length] = '\0';
+
+	uint32_t columns_count;
+	if (!read_u32(results->file, &columns_count) || columns_count > RUNNER_RESULTS_MAX_COLUMNS) {
+		runnerresults_close(results);
+		return false;
+	}
+	results->columns_count = columns_count;
+
+	for (size_t i = 0; i < columns_count; i += 1) {
+		unsigned char description[4];
+		if (fread(description, 1, sizeof(description), results->file) != sizeof(description)
+			|| description[0] >= RUNNERCOLUMNTYPE_COUNT
+			|| description[2] >= RUNNER_RESULTS_MAX_COLUMN_NAME
+			|| fread(results->column_names[i], 1, description[2], results->file) != description[2]
+		) {
+			runnerresults_close(results);
+			return false;
+		}
+		results->column_names[i][description[2]] = '\0';
+
+		results->columns[i].name = results->column_names[i];
+		results->columns[i].type = (Runner_Column_Type)description[0];
+		results->columns[i].precision = description[1];
+	}
+
+	return true;
+}
+
+bool runnerresults_read(Runner_Results* results, Runner_Value* values) {
+	unsigned char row[RUNNER_RESULTS_MAX_COLUMNS * 8];
+	// A row cut short by an interrupted run is dropped
+	if (fread(row, 8, results->columns_count, results->file) != results->columns_count) {
+		return false;
+	}
+
+	for (size_t i = 0; i < results->columns_count; i += 1) {
+		values[i].u64 = decode_u64(row + i * 8);
+	}
+	return true;
+}
+
+void runnerresults_close(Runner_Results* results) {
+	if (results->file != NULL) {
+		fclose(results->file);
+		results->file = NULL;
+	}
+	free(results->metadata);
+	results->metadata = NULL;
+}
@@ -0,0 +1,552 @@
+#ifndef HARNESS_RUNNER_H
+#define HARNESS_RUNNER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "sorts/sorts.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CONFIG
+////////////////////////////////////////////////////////////////////////////////
+
+#define RUNNER_MAX_RELATIVE_ERROR 0.00001
+#define RUNNER_TEST_COUNT 250
+
+#define RUNNER_STARTING_ARRAY_LENGTH 100
+#define RUNNER_ENDING_ARRAY_LENGTH 100000
+#define RUNNER_MIN_ARRAY_ELEMENT 10
+#define RUNNER_MAX_ARRAY_ELEMENT 100000 + RUNNER_MIN_ARRAY_ELEMENT
+
+#define RUNNER_ARRAY_LENGTH 10000
+#define RUNNER_STARTING_ELEMENT_RANGE 10
+#define RUNNER_ENDING_ELEMENT_RANGE 1000000
+
+// Parallel kernels only, swept from 1 thread to one thread per usable cpu
+#define RUNNER_THREAD_COUNT_ARRAY_LENGTH 10000000
+
+// Only with Runner_Options.large_array_lengths, swept from
+// RUNNER_LARGE_STARTING_ARRAY_LENGTH to RUNNER_LARGE_ENDING_ARRAY_LENGTH in
+// RUNNER_LARGE_ARRAY_LENGTH_COUNT geometric steps, with every cpu available
+// to parallel kernels. The largest arrays need a few GiB of memory.
+#define RUNNER_LARGE_STARTING_ARRAY_LENGTH 1000000
+#define RUNNER_LARGE_ENDING_ARRAY_LENGTH 100000000
+#define RUNNER_LARGE_ARRAY_LENGTH_COUNT 5
+
+// Record kernels only, swept over the payload sizes from
+// RUNNER_STARTING_PAYLOAD_SIZE to RUNNER_ENDING_PAYLOAD_SIZE bytes, in steps
+// of RUNNER_PAYLOAD_SIZE_STEP, once per layout
+#define RUNNER_PAYLOAD_ARRAY_LENGTH 100000
+#define RUNNER_STARTING_PAYLOAD_SIZE 8
+#define RUNNER_ENDING_PAYLOAD_SIZE 64
+#define RUNNER_PAYLOAD_SIZE_STEP 8
+#define RUNNER_PAYLOAD_SIZE_COUNT ((RUNNER_ENDING_PAYLOAD_SIZE - RUNNER_STARTING_PAYLOAD_SIZE) / RUNNER_PAYLOAD_SIZE_STEP + 1)
+
+// Input pool timing: at most RUNNER_INPUT_POOL_MAX_ARRAYS arrays are sorted
+// between two timestamps, and the pool holds at least RUNNER_INPUT_POOL_LENGTH
+// elements in total
+#define RUNNER_INPUT_POOL_LENGTH (1 << 20)
+#define RUNNER_INPUT_POOL_MAX_ARRAYS 64
+
+// Number of distinct values of the few unique distribution
+#define RUNNER_FEW_UNIQUE_VALUES 8
+// One element in RUNNER_PRESORTED_DISORDER is out of place in the sorted tail
+// and nearly sorted distributions (at least one)
+#define RUNNER_PRESORTED_DISORDER 100
+
+#define RUNNER_MAX_THREADS 1024
+// Longest progress label of a benchmark point
+#define RUNNER_POINT_LABEL_SIZE 256
+
+#define RUNNER_RESULTS_DIRECTORY "./results"
+#define RUNNER_ARRAY_LENGTH_OUTPUT_SUFFIX ".array_length"
+#define RUNNER_INPUT_RANGE_OUTPUT_SUFFIX ".input_range"
+#define RUNNER_THREAD_COUNT_OUTPUT_SUFFIX ".thread_count"
+#define RUNNER_AOS_PAYLOAD_SIZE_OUTPUT_SUFFIX ".aos_payload_size"
+#define RUNNER_SOA_PAYLOAD_SIZE_OUTPUT_SUFFIX ".soa_payload_size"
+#define RUNNER_LARGE_ARRAY_LENGTH_OUTPUT_SUFFIX ".large_array_length"
+// Every sample of every point, only written with more than one sample per point
+#define RUNNER_ARRAY_LENGTH_SAMPLES_OUTPUT_SUFFIX ".array_length.samples"
+#define RUNNER_INPUT_RANGE_SAMPLES_OUTPUT_SUFFIX ".input_range.samples"
+#define RUNNER_THREAD_COUNT_SAMPLES_OUTPUT_SUFFIX ".thread_count.samples"
+#define RUNNER_AOS_PAYLOAD_SIZE_SAMPLES_OUTPUT_SUFFIX ".aos_payload_size.samples"
+#define RUNNER_SOA_PAYLOAD_SIZE_SAMPLES_OUTPUT_SUFFIX ".soa_payload_size.samples"
+#define RUNNER_LARGE_ARRAY_LENGTH_SAMPLES_OUTPUT_SUFFIX ".large_array_length.samples"
+#define RUNNER_CSV_EXTENSION ".csv"
+#define RUNNER_BINARY_EXTENSION ".sbr"
+
+// Binary results files
+#define RUNNER_RESULTS_VERSION 1
+#define RUNNER_RESULTS_MAX_COLUMNS 64
+#define RUNNER_RESULTS_MAX_COLUMN_NAME 64
+#define RUNNER_RESULTS_BUFFER_SIZE (1 << 20)
+#define RUNNER_METADATA_CAPACITY 4096
+
+// Statistics of the samples of a point
+#define RUNNER_BOOTSTRAP_RESAMPLES 1000
+#define RUNNER_CONFIDENCE_LEVEL 0.95
+// Samples farther than RUNNER_OUTLIER_FENCE interquartile ranges from the
+// quartiles are flagged as outliers
+#define RUNNER_OUTLIER_FENCE 1.5
+
+// Adaptive sampling: samples are only RUNNER_ADAPTIVE_SAMPLE_RELATIVE_ERROR
+// precise against the clock, and at least RUNNER_ADAPTIVE_MIN_SAMPLES of them
+// are measured before checking the confidence interval
+#define RUNNER_ADAPTIVE_SAMPLE_RELATIVE_ERROR 0.001
+#define RUNNER_ADAPTIVE_MIN_SAMPLES 5
+#define RUNNER_ADAPTIVE_MAX_SAMPLES 10000
+#define RUNNER_ADAPTIVE_Z_SCORE 1.96
+#define RUNNER_DEFAULT_POINT_TIME_BUDGET 1.0
+
+// Scan microbenchmark (-m), from RUNNER_SCAN_MIN_BYTES to RUNNER_SCAN_MAX_BYTES
+// multiplying by RUNNER_SCAN_BYTES_STEP, so from the L1 cache to the memory
+#define RUNNER_SCAN_MIN_BYTES (16 << 10)
+#define RUNNER_SCAN_MAX_BYTES (256 << 20)
+#define RUNNER_SCAN_BYTES_STEP 4
+#define RUNNER_SCAN_REPETITIONS 5
+#define RUNNER_SCAN_MIN_EXECUTION_TIME 0.05
+
+// Elearning mode (-e): stdin is read and stdout written in blocks of this many
+// bytes, numbers may span blocks
+#define RUNNER_ELEARNING_BLOCK_SIZE (1 << 20)
+
+// External sort mode (-x): memory held by the elements at once by default, in
+// MiB. The merge reads every run in blocks of at least
+// RUNNER_EXTERNAL_MIN_BLOCK_SIZE bytes, merging more runs than the memory
+// allows at that size in several passes.
+#define RUNNER_EXTERNAL_DEFAULT_MEMORY_BUDGET 1024
+#define RUNNER_EXTERNAL_MIN_BLOCK_SIZE (1 << 20)
+#define RUNNER_EXTERNAL_OUTPUT_SUFFIX ".sorted"
+// The sorted runs are spilled next to the output, in files with these suffixes
+#define RUNNER_EXTERNAL_RUNS_SUFFIX ".runs"
+#define RUNNER_EXTERNAL_MERGED_RUNS_SUFFIX ".runs.merged"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// RANDOM GENERATORS
+////////////////////////////////////////////////////////////////////////////////
+
+// Independent streams stepped together by runnerrandom_fill
+#define RUNNER_RANDOM_LANES 4
+
+typedef enum {
+	// xoshiro256** (default)
+	RUNNERGENERATOR_XOSHIRO,
+	// PCG-XSH-RR 64/32, two outputs per 64 bit number
+	RUNNERGENERATOR_PCG,
+
+	RUNNERGENERATOR_COUNT,
+} Runner_Generator;
+
+typedef struct {
+	Runner_Generator generator;
+	uint64_t state[4];
+} Runner_Random;
+
+const char* runnergenerator_name(Runner_Generator generator);
+bool runnergenerator_parse(const char* name, Runner_Generator* generator);
+
+// The same generator and seed always give the same sequence, on every platform
+void runnerrandom_seed(Runner_Random* random, Runner_Generator generator, uint64_t seed);
+uint64_t runnerrandom_next(Runner_Random* random);
+// Uniform in [0, bound), without the bias of a plain modulo
+uint64_t runnerrandom_bounded(Runner_Random* random, uint64_t bound);
+// Fills array with elements uniform in [minimum_element, maximum_element]
+void runnerrandom_fill(Runner_Random* random, int64_t* array, size_t array_length, int64_t minimum_element, int64_t maximum_element);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// STATISTICS
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	size_t count;
+	double mean;
+	double min;
+	double median;
+	double p95;
+	double stddev; // NAN with a single sample
+	// Bootstrap confidence interval of the mean at RUNNER_CONFIDENCE_LEVEL, NAN
+	// with a single sample
+	double ci_low;
+	double ci_high;
+	// Half width of the confidence interval relative to the mean
+	double relative_precision;
+	size_t outlier_count;
+} Runner_Summary;
+
+// Sets outliers[i] for every sample outside Tukey's fences (never with less
+// than 4 samples). random is only used to draw the bootstrap resamples.
+void runnersummary_compute(Runner_Summary* summary, const double* samples, size_t count, bool* outliers, Runner_Random* random);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// RESULTS FILES
+////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+	// The original csv files, one row per line
+	RUNNEROUTPUTFORMAT_CSV,
+	// Binary results files, see Runner_Results
+	RUNNEROUTPUTFORMAT_BINARY,
+
+	RUNNEROUTPUTFORMAT_COUNT,
+} Runner_Output_Format;
+
+const char* runneroutputformat_name(Runner_Output_Format format);
+bool runneroutputformat_parse(const char* name, Runner_Output_Format* format);
+
+typedef enum {
+	RUNNERCOLUMNTYPE_U64,
+	RUNNERCOLUMNTYPE_F64,
+
+	RUNNERCOLUMNTYPE_COUNT,
+} Runner_Column_Type;
+
+typedef struct {
+	const char* name;
+	Runner_Column_Type type;
+	// Decimal digits of the F64 columns in the csv files
+	unsigned precision;
+} Runner_Column;
+
+typedef union {
+	uint64_t u64;
+	double f64;
+} Runner_Value;
+
+// Fills metadata with key=value lines describing the machine and the build
+void runner_metadata_collect(char* metadata, size_t metadata_capacity);
+void runner_metadata_append(char* metadata, size_t metadata_capacity, const char* key, const char* value);
+
+// Writes values as a csv row, in the format of the original csv files
+void runner_write_csv_row(FILE* file, const Runner_Column* columns, size_t columns_count, const Runner_Value* values);
+
+// A binary results file: a header with the metadata and the name, type and
+// csv precision of every column, followed by rows of 8 byte little endian
+// values. Rows are only appended, and a row cut short by an interrupted run is
+// ignored when reading.
+typedef struct {
+	FILE* file;
+
+	Runner_Column columns[RUNNER_RESULTS_MAX_COLUMNS];
+	size_t columns_count;
+	// Only set when reading
+	char column_names[RUNNER_RESULTS_MAX_COLUMNS][RUNNER_RESULTS_MAX_COLUMN_NAME];
+	char* metadata;
+} Runner_Results;
+
+bool runnerresults_create(Runner_Results* results, const char* path, const Runner_Column* columns, size_t columns_count, const char* metadata);
+void runnerresults_append(Runner_Results* results, const Runner_Value* values);
+bool runnerresults_open(Runner_Results* results, const char* path);
+// Returns false at the end of the file
+bool runnerresults_read(Runner_Results* results, Runner_Value* values);
+void runnerresults_close(Runner_Results* results);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// HARDWARE COUNTERS
+////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+	RUNNERCOUNTER_CYCLES,
+	RUNNERCOUNTER_INSTRUCTIONS,
+	RUNNERCOUNTER_BRANCH_MISSES,
+	RUNNERCOUNTER_L1D_MISSES, // L1 data cache read misses
+	RUNNERCOUNTER_LLC_MISSES, // last level cache read misses
+
+	RUNNERCOUNTER_COUNT,
+} Runner_Counter;
+
+// Hardware counters of the calling thread, through perf_event_open on Linux.
+// Only the thread that opened them is counted, so they are not opened for the
+// SORTKERNEL_PARALLEL kernels, whose counters are all NAN: the work they hand
+// to the task pool would be left out.
+typedef struct {
+	int group_descriptor; // -1 when no counter could be opened
+	int descriptors[RUNNERCOUNTER_COUNT]; // -1 for the unsupported counters
+	uint64_t ids[RUNNERCOUNTER_COUNT];
+} Runner_Counters;
+
+const char* runnercounter_name(Runner_Counter counter);
+
+// Returns false when no counter is available, either because the platform does
+// not support them or because perf_event_paranoid forbids them. The other
+// functions can still be called, and do nothing.
+bool runnercounters_open(Runner_Counters* counters);
+void runnercounters_close(Runner_Counters* counters);
+void runnercounters_reset(Runner_Counters* counters);
+// Counting is only active between start and stop
+void runnercounters_start(Runner_Counters* counters);
+void runnercounters_stop(Runner_Counters* counters);
+// Writes every counter since the last reset divided by divisor, NAN for the
+// ones that are not available
+void runnercounters_read(Runner_Counters* counters, double divisor, double* values);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// BENCHMARK MODE
+////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+	// Generates every array right before sorting it and subtracts an estimate
+	// of the generation time (the original measurement)
+	RUNNERTIMING_SUBTRACT_INIT,
+	// Generates a pool of arrays before timing, and only times the kernels
+	// sorting batches of copies of it
+	RUNNERTIMING_INPUT_POOL,
+
+	RUNNERTIMING_COUNT,
+} Runner_Timing;
+
+const char* runnertiming_name(Runner_Timing timing);
+bool runnertiming_parse(const char* name, Runner_Timing* timing);
+
+typedef struct {
+	// Number of benchmark points measured concurrently. 1 measures everything
+	// on the calling thread, 0 uses one thread per available cpu. Parallel
+	// kernels are always measured one point at a time.
+	size_t thread_count;
+	// Only use one logical cpu per physical core, so that no two measurements
+	// share the execution units of the same core
+	bool physical_cores_only;
+	// Measures the hardware counters of every sort, if the system allows it
+	bool hardware_counters;
+	// Also sweeps the kernels other than the record ones over the large array
+	// lengths, see RUNNER_LARGE_ENDING_ARRAY_LENGTH
+	bool large_array_lengths;
+	Runner_Timing timing;
+	Runner_Generator generator;
+	// Base of the seeds of the benchmark points, see runner_point_seed
+	uint64_t seed;
+	// Independent measurements of every point, each one giving an average time
+	// per sort
+	size_t sample_count;
+	// If greater than 0, sample_count is ignored and every point is sampled
+	// until the half width of its confidence interval is at most
+	// target_precision times its mean, or until point_time_budget seconds
+	double target_precision;
+	double point_time_budget;
+	Runner_Output_Format output_format;
+} Runner_Options;
+
+typedef enum {
+	// Every element uniformly random in the input range (the original input)
+	RUNNERDISTRIBUTION_UNIFORM,
+	// Evenly spread over the input range, ascending
+	RUNNERDISTRIBUTION_SORTED,
+	// Evenly spread over the input range, descending
+	RUNNERDISTRIBUTION_REVERSED,
+	// Ascending up to the middle of the array, then descending
+	RUNNERDISTRIBUTION_ORGAN_PIPE,
+	// RUNNER_FEW_UNIQUE_VALUES evenly spaced values, in random order
+	RUNNERDISTRIBUTION_FEW_UNIQUE,
+	// Sorted, followed by a few uniformly random elements, like a sorted
+	// array with new elements appended
+	RUNNERDISTRIBUTION_SORTED_TAIL,
+	// Sorted, with a few random pairs of elements swapped
+	RUNNERDISTRIBUTION_NEARLY_SORTED,
+
+	RUNNERDISTRIBUTION_COUNT,
+} Runner_Distribution;
+
+const char* runnerdistribution_name(Runner_Distribution distribution);
+bool runnerdistribution_parse(const char* name, Runner_Distribution* distribution);
+
+typedef enum {
+	RUNNERAXIS_ARRAY_LENGTH,
+	RUNNERAXIS_INPUT_RANGE,
+	RUNNERAXIS_THREAD_COUNT,
+	RUNNERAXIS_AOS_PAYLOAD_SIZE,
+	RUNNERAXIS_SOA_PAYLOAD_SIZE,
+	RUNNERAXIS_LARGE_ARRAY_LENGTH,
+
+	RUNNERAXIS_COUNT,
+} Runner_Axis;
+
+typedef struct {
+	uint64_t x; // array length, input range, thread count or payload size
+	double average_time;
+	size_t peak_recursion_depth; // deepest recursion of all the sorts
+	double allocations_per_sort; // heap allocations done by the kernel per call
+	size_t peak_bytes; // most temporary memory held by one of the sorts
+	double counters[RUNNERCOUNTER_COUNT]; // per sort, NAN when not measured
+	// Harness time per sort still included in average_time, NAN when not known
+	double harness_overhead;
+	uint64_t seed; // of the generator of the inputs
+
+	// Of the average times of the samples
+	Runner_Summary summary;
+	// summary.count samples, owned by the point until it is written
+	double* samples;
+	bool* sample_outliers;
+} Runner_Point;
+
+typedef struct {
+	int64_t* array_buffer;
+	size_t array_buffer_size;
+	// Untouched inputs of the input pool timing, NULL with the other timing
+	int64_t* input_pool;
+	size_t input_pool_capacity;
+
+	Runner_Random random;
+	size_t cpu;
+
+	// Installed as the thread scratch arena while the worker runs a job, so
+	// that it is reused by every sort of the worker
+	Scratch_Arena scratch;
+	// Opened for the thread running a job when hardware counters are enabled
+	Runner_Counters counters;
+
+	// Records of the record kernels: the pool holds the generated ones, which
+	// are copied in the buffer before every sort. Grown on demand.
+	Record_Layout record_layout;
+	size_t payload_size;
+	unsigned char* record_pool;
+	unsigned char* record_buffer;
+	size_t record_buffer_capacity;
+} Runner_Worker;
+
+// A results table, in the chosen output format
+typedef struct {
+	bool open;
+	FILE* csv_file;
+	Runner_Results results;
+	const Runner_Column* columns;
+	size_t columns_count;
+} Runner_Output;
+
+typedef struct {
+	double clock_precision;
+	double min_execution_time;
+	// For 1 element, conversion to the element type included
+	double array_average_init_time[RUNNERDISTRIBUTION_COUNT][ELEMENTTYPE_COUNT];
+	Runner_Timing timing;
+	double batch_overhead; // input pool timing, per pair of timestamps
+	double call_overhead; // input pool timing, per kernel call
+	Runner_Generator generator;
+	uint64_t seed;
+	size_t sample_count;
+	double target_precision;
+	double point_time_budget;
+	double min_sample_execution_time; // adaptive sampling
+	bool write_samples;
+
+	double length_constant_a;
+	double length_constant_b;
+	bool large_array_lengths;
+	double large_length_constant_a;
+	double large_length_constant_b;
+	double input_range_constant_a;
+	double input_range_constant_b;
+
+	size_t cpus[RUNNER_MAX_THREADS];
+	size_t cpus_count;
+	size_t thread_count;
+	bool pin_threads;
+	bool counters_enabled;
+	Runner_Worker* workers;
+
+	Runner_Distribution distribution;
+	Element_Type element_type;
+
+	Runner_Output_Format output_format;
+	// Machine, build and settings of the run, stored in every binary file
+	char metadata[RUNNER_METADATA_CAPACITY];
+	Runner_Output outputs[RUNNERAXIS_COUNT];
+	Runner_Output sample_outputs[RUNNERAXIS_COUNT];
+} Runner;
+
+extern Runner g_runner;
+
+// Calibrates the clock and the array initialization time. Must be called once
+// before benchmarking any number of kernels.
+void runner_init(const Runner_Options* options);
+void runner_terminate(void);
+
+// Runs both the array length and the input range sweeps for the given kernel,
+// plus the thread count sweep for parallel kernels and the large array length
+// sweep when enabled, writing the results in
+// RUNNER_RESULTS_DIRECTORY/<kernel name>[.<pivot>][.<leaf><cutoff>][.<distribution>][.<type>].*.csv.
+// The pivot strategy is the current sorts_pivot_strategy() and the leaf sort
+// the current sorts_small_sort(), and like the distribution and the element
+// type they only appear in the file name when they are not the default ones. Element types other than ELEMENTTYPE_INT64 require
+// SORTKERNEL_ELEMENT_TYPES.
+void runner_benchmark_kernel(const Sort_Kernel* kernel, Runner_Distribution distribution, Element_Type element_type);
+
+// Seed of the inputs of a benchmark point: running the generator from it
+// reproduces the exact arrays the point sorted
+uint64_t runner_point_seed(Runner_Axis axis, size_t iteration);
+
+void randomize_array(Runner_Worker* worker, int64_t* array, size_t array_length, int64_t minimum_element, int64_t maximum_element);
+// Fills array with elements in [minimum_element, maximum_element] (both always
+// present) following the given distribution
+void generate_array(Runner_Worker* worker, Runner_Distribution distribution, int64_t* array, size_t array_length, int64_t minimum_element, int64_t maximum_element);
+// Same as generate_array, with the elements converted to the given type. array
+// must have room for array_length int64_t elements.
+void generate_typed_array(Runner_Worker* worker, Runner_Distribution distribution, Element_Type element_type, void* array, size_t array_length, int64_t minimum_element, int64_t maximum_element);
+bool is_array_sorted(int64_t* array, size_t array_length);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CPUS
+////////////////////////////////////////////////////////////////////////////////
+
+// Fills cpus with the ids of the logical cpus the process may run on. If
+// physical_only is set, only the first logical cpu of every physical core is
+// listed. Returns the number of cpus written.
+size_t runner_list_cpus(size_t* cpus, size_t cpus_capacity, bool physical_only);
+
+// Pins the calling thread to the given logical cpu. Returns false where
+// pinning is not supported.
+bool runner_pin_thread(size_t cpu);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ELEARNING MODE
+////////////////////////////////////////////////////////////////////////////////
+
+// Reads a line of integers from stdin, of any length, sorts it with the given
+// kernel and prints it on stdout, every number followed by a space. Numbers are
+// the longest sequences of digits, with the minus sign right before them; any
+// other byte separates them.
+void run_elearning_mode(const Sort_Kernel* kernel);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// EXTERNAL SORT MODE
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	// Raw int64_t elements in the byte order of the machine, and so is the
+	// output. NULL output_path writes <input_path>RUNNER_EXTERNAL_OUTPUT_SUFFIX.
+	const char* input_path;
+	const char* output_path;
+	// Bytes of elements held in memory at once, by the chunks sorted in memory
+	// and then by the buffers of the merge. The memory the kernel allocates
+	// for itself comes on top.
+	size_t memory_budget;
+} Runner_External_Options;
+
+// Sorts a file that may not fit in memory: the input is read in chunks of the
+// memory budget, every chunk is sorted by the given kernel and spilled as
+// sorted runs, and the runs are merged with a loser tree. Parallel kernels
+// sort a whole chunk with all their threads, the others sort one part of it
+// per thread of sorts_thread_count(). Prints the time spent in I/O apart from
+// the time spent sorting and merging. Returns false, with a message on
+// stderr, if a file cannot be read or written.
+bool run_external_mode(const Sort_Kernel* kernel, const Runner_External_Options* options);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SCAN BENCHMARK MODE
+////////////////////////////////////////////////////////////////////////////////
+
+// Prints the throughput of the min/max and sortedness scans (see sorts/scan.h)
+// with every instruction set the cpu supports, next to the one of memcpy.
+void run_scan_benchmark_mode(void);
+
+#endif
@@ -0,0 +1,138 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+#include "sorts/scan.h"
+#include "harness/runner.h"
+
+typedef double (*Scan_Benchmark_Function)(Scan_Isa isa, const int64_t* array, int64_t* destination, size_t array_length);
+
+static volatile int64_t g_scan_sink;
+
+static double elapsed_seconds(struct timespec start) {
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	return (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1000000000.0;
+}
+
+// Bytes moved by every call, read + written for the copy
+static double run_copy(Scan_Isa isa, const int64_t* array, int64_t* destination, size_t array_length) {
+	(void)isa;
+
+	memcpy(destination, array, array_length * sizeof(int64_t));
+	g_scan_sink = destination[array_length - 1];
+
+	return (double)(2 * array_length * sizeof(int64_t));
+}
+
+static double run_min_max(Scan_Isa isa, const int64_t* array, int64_t* destination, size_t array_length) {
+	(void)destination;
+
+	int64_t min;
+	int64_t max;
+	scan_min_max_isa(isa, array, array_length, &min, &max);
+	g_scan_sink = min ^ max;
+
+	return (double)(array_length * sizeof(int64_t));
+}
+
+static double run_is_sorted(Scan_Isa isa, const int64_t* array, int64_t* destination, size_t array_length) {
+	(void)destination;
+
+	bool sorted = scan_is_sorted_isa(isa, array, array_length);
+	assert(sorted);
+	g_scan_sink = sorted;
+
+	return (double)(array_length * sizeof(int64_t));
+}
+
+// Best throughput, in GB/s, of RUNNER_SCAN_REPETITIONS timings of at least
+// RUNNER_SCAN_MIN_EXECUTION_TIME each
+static double measure_throughput(Scan_Benchmark_Function function, Scan_Isa isa, const int64_t* array, int64_t* destination, size_t array_length) {
+	double best_throughput = 0.0;
+
+	for (size_t i = 0; i < RUNNER_SCAN_REPETITIONS; i += 1) {
+		double bytes = 0.0;
+		double duration = 0.0;
+
+		struct timespec start;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		do {
+			bytes += function(isa, array, destination, array_length);
+			duration = elapsed_seconds(start);
+		} while (duration < RUNNER_SCAN_MIN_EXECUTION_TIME);
+
+		double throughput = bytes / duration / 1e9;
+		if (throughput > best_throughput) {
+			best_throughput = throughput;
+		}
+	}
+
+	return best_throughput;
+}
+
+void run_scan_benchmark_mode(void) {
+	size_t max_array_length = RUNNER_SCAN_MAX_BYTES / sizeof(int64_t);
+
+	int64_t* random_array = malloc(max_array_length * sizeof(int64_t));
+	int64_t* sorted_array = malloc(max_array_length * sizeof(int64_t));
+	int64_t* destination = malloc(max_array_length * sizeof(int64_t));
+	assert(random_array != NULL && sorted_array != NULL && destination != NULL);
+
+	Runner_Random random;
+	runnerrandom_seed(&random, RUNNERGENERATOR_XOSHIRO, 0);
+	runnerrandom_fill(&random, random_array, max_array_length, -1000000000000, 1000000000000);
+	for (size_t i = 0; i < max_array_length; i += 1) {
+		sorted_array[i] = (int64_t)i;
+	}
+	// Also faults in the pages
+	memset(destination, 0, max_array_length * sizeof(int64_t));
+
+	printf("Scans dispatched to %s. Throughput in GB/s, memcpy counts read + written bytes and\n", scanisa_name(scan_isa()));
+	printf("is the reference for the memory bandwidth (%% columns).\n\n");
+
+	printf("%12s %9s", "bytes", "memcpy");
+	for (size_t i = 0; i < SCANISA_COUNT; i += 1) {
+		if (!scanisa_supported((Scan_Isa)i)) {
+			continue;
+		}
+
+		char header[32];
+		snprintf(header, sizeof(header), "minmax/%s", scanisa_name((Scan_Isa)i));
+		printf(" %16s %5s", header, "%");
+		snprintf(header, sizeof(header), "sorted/%s", scanisa_name((Scan_Isa)i));
+		printf(" %16s %5s", header, "%");
+	}
+	printf("\n");
+
+	for (size_t bytes = RUNNER_SCAN_MIN_BYTES; bytes <= RUNNER_SCAN_MAX_BYTES; bytes *= RUNNER_SCAN_BYTES_STEP) {
+		size_t array_length = bytes / sizeof(int64_t);
+
+		double copy_throughput = measure_throughput(run_copy, SCANISA_SCALAR, random_array, destination, array_length);
+		printf("%12llu %9.2f", (unsigned long long)bytes, copy_throughput);
+
+		for (size_t i = 0; i < SCANISA_COUNT; i += 1) {
+			Scan_Isa isa = (Scan_Isa)i;
+			if (!scanisa_supported(isa)) {
+				continue;
+			}
+
+			double min_max_throughput = measure_throughput(run_min_max, isa, random_array, destination, array_length);
+			double is_sorted_throughput = measure_throughput(run_is_sorted, isa, sorted_array, destination, array_length);
+			printf(" %16.2f %4.0f%%", min_max_throughput, 100.0 * min_max_throughput / copy_throughput);
+			printf(" %16.2f %4.0f%%", is_sorted_throughput, 100.0 * is_sorted_throughput / copy_throughput);
+		}
+		printf("\n");
+		fflush(stdout);
+	}
+
+	free(random_array);
+	free(sorted_array);
+	free(destination);
+}
@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#include "harness/runner.h"
+
+static int compare_doubles(const void* a, const void* b) {
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+// Linear interpolation between the closest ranks of the sorted samples
+static double sorted_percentile(const double* sorted_samples, size_t count, double percentile) {
+	double rank = percentile * (double)(count - 1);
+	size_t lower = (size_t)rank;
+	if (lower + 1 >= count) {
+		return sorted_samples[count - 1];
+	}
+
+	double fraction = rank - (double)lower;
+	return sorted_samples[lower] + (sorted_samples[lower + 1] - sorted_samples[lower]) * fraction;
+}
+
+// Percentile bootstrap of the mean
+static void bootstrap_mean_interval(const double* samples, size_t count, Runner_Random* random, double* low, double* high) {
+	double* means = malloc(sizeof(double) * RUNNER_BOOTSTRAP_RESAMPLES);
+	assert(means != NULL);
+
+	for (size_t i = 0; i < RUNNER_BOOTSTRAP_RESAMPLES; i += 1) {
+		double sum = 0.0;
+		for (size_t j = 0; j < count; j += 1) {
+			sum += samples[runnerrandom_bounded(random, count)];
+		}
+		means[i] = sum / (double)count;
+	}
+	qsort(means, RUNNER_BOOTSTRAP_RESAMPLES, sizeof(double), compare_doubles);
+
+	double tail = (1.0 - RUNNER_CONFIDENCE_LEVEL) / 2.0;
+	*low = sorted_percentile(means, RUNNER_BOOTSTRAP_RESAMPLES, tail);
+	*high = sorted_percentile(means, RUNNER_BOOTSTRAP_RESAMPLES, 1.0 - tail);
+
+	free(means);
+}
+
+void runnersummary_compute(Runner_Summary* summary, const double* samples, size_t count, bool* outliers, Runner_Random* random) {
+	assert(count > 0);
+
+	double* sorted_samples = malloc(sizeof(double) * count);
+	assert(sorted_samples != NULL);
+	memcpy(sorted_samples, samples, sizeof(double) * count);
+	qsort(sorted_samples, count, sizeof(double), compare_doubles);
+
+	double sum = 0.0;
+	for (size_t i = 0; i < count; i += 1) {
+		sum += samples[i];
+	}
+
+	summary->count = count;
+	summary->mean = sum / (double)count;
+	summary->min = sorted_samples[0];
+	summary->median = sorted_percentile(sorted_samples, count, 0.5);
+	summary->p95 = sorted_percentile(sorted_samples, count, 0.95);
+
+	summary->stddev = NAN;
+	summary->ci_low = NAN;
+	summary->ci_high = NAN;
+	summary->relative_precision = NAN;
+	if (count > 1) {
+		double squares = 0.0;
+		for (size_t i = 0; i < count; i += 1) {
+			squares += (samples[i] - summary->mean) * (samples[i] - summary->mean);
+		}
+		summary->stddev = sqrt(squares / (double)(count - 1));
+
+		bootstrap_mean_interval(samples, count, random, &summary->ci_low, &summary->ci_high);
+		summary->relative_precision = (summary->ci_high - summary->ci_low) / 2.0 / summary->mean;
+	}
+
+	// Tukey's fences, only meaningful with a few samples
+	double lower_fence = -INFINITY;
+	double upper_fence = INFINITY;
+	if (count >= 4) {
+		double first_quartile = sorted_percentile(sorted_samples, count, 0.25);
+		double third_quartile = sorted_percentile(sorted_samples, count, 0.75);
+		double interquartile_range = third_quartile - first_quartile;
+
+		lower_fence = first_quartile - RUNNER_OUTLIER_FENCE * interquartile_range;
+		upper_fence = third_quartile + RUNNER_OUTLIER_FENCE * interquartile_range;
+	}
+
+	summary->outlier_count = 0;
+	for (size_t i = 0; i < count; i += 1) {
+		outliers[i] = samples[i] < lower_fence || samples[i] > upper_fence;
+		if (outliers[i]) {
+			summary->outlier_count += 1;
+		}
+	}
+
+	free(sorted_samples);
+}
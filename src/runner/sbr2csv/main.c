@@ -0,0 +1,103 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "harness/runner.h"
+
+// Converts the binary results files written by sortbench -o binary back to
+// the csv files sortbench would have written
+void print_usage(const char* program_name) {
+	fprintf(stderr,
+		"Usage: %s [-m] [-c] file.sbr...\n"
+		"\t-m: prints the metadata of every file instead of converting it\n"
+		"\t-c: writes the csv on stdout instead of next to the file\n",
+		program_name
+	);
+}
+
+bool convert_file(const char* path, bool metadata_only, bool to_stdout) {
+	Runner_Results results;
+	if (!runnerresults_open(&results, path)) {
+		fprintf(stderr, "%s is not a results file\n", path);
+		return false;
+	}
+
+	if (metadata_only) {
+		printf("%s:\n%s", path, results.metadata);
+		for (size_t i = 0; i < results.columns_count; i += 1) {
+			printf("column=%s\n", results.columns[i].name);
+		}
+		printf("\n");
+		runnerresults_close(&results);
+		return true;
+	}
+
+	FILE* output = stdout;
+	if (!to_stdout) {
+		char output_path[1024];
+		size_t path_length = strlen(path);
+		size_t extension_length = strlen(RUNNER_BINARY_EXTENSION);
+		if (path_length > extension_length && strcmp(path + path_length - extension_length, RUNNER_BINARY_EXTENSION) == 0) {
+			path_length -= extension_length;
+		}
+
+		int written = snprintf(output_path, sizeof(output_path), "%.*s" RUNNER_CSV_EXTENSION, (int)path_length, path);
+		if (written < 0 || (size_t)written >= sizeof(output_path)) {
+			fprintf(stderr, "Path too long: %s\n", path);
+			runnerresults_close(&results);
+			return false;
+		}
+
+		output = fopen(output_path, "w");
+		if (output == NULL) {
+			fprintf(stderr, "Could not create %s\n", output_path);
+			runnerresults_close(&results);
+			return false;
+		}
+	}
+
+	Runner_Value values[RUNNER_RESULTS_MAX_COLUMNS];
+	while (runnerresults_read(&results, values)) {
+		runner_write_csv_row(output, results.columns, results.columns_count, values);
+	}
+
+	if (output != stdout) {
+		fclose(output);
+	}
+	runnerresults_close(&results);
+	return true;
+}
+
+int main(int argc, char** argv) {
+	bool metadata_only = false;
+	bool to_stdout = false;
+
+	int option;
+	while ((option = getopt(argc, argv, "mch")) != -1) {
+		switch (option) {
+		case 'm':
+			metadata_only = true; break;
+		case 'c':
+			to_stdout = true; break;
+		case 'h':
+			print_usage(argv[0]); return EXIT_SUCCESS;
+		default:
+			print_usage(argv[0]); return EXIT_FAILURE;
+		}
+	}
+	if (optind == argc) {
+		print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	bool success = true;
+	for (int i = optind; i < argc; i += 1) {
+		success = convert_file(argv[i], metadata_only, to_stdout) && success;
+	}
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,545 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "sorts/sorts.h"
+#include "sorts/partition.h"
+#include "harness/runner.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COMMAND LINE
+////////////////////////////////////////////////////////////////////////////////
+
+enum Runner_Mode { RUNNERMODE_BENCHMARK, RUNNERMODE_ELEARNING, RUNNERMODE_SCAN, RUNNERMODE_EXTERNAL };
+
+typedef struct {
+	enum Runner_Mode mode;
+	Runner_Options runner_options;
+	Runner_External_Options external_options;
+
+	const Sort_Kernel* kernels[64];
+	size_t kernels_count;
+
+	Pivot_Strategy pivot_strategies[PIVOTSTRATEGY_COUNT];
+	size_t pivot_strategies_count;
+	Runner_Distribution distributions[RUNNERDISTRIBUTION_COUNT];
+	size_t distributions_count;
+	Element_Type element_types[ELEMENTTYPE_COUNT];
+	size_t element_types_count;
+	Small_Sort small_sorts[SMALLSORT_COUNT];
+	size_t small_sorts_count;
+	size_t small_sort_cutoffs[SMALLSORT_MAX_LENGTH];
+	size_t small_sort_cutoffs_count;
+} Options;
+
+void print_usage(const char* program_name) {
+	fprintf(stderr,
+		"Usage: %s [-e] [-m] [-x input] [-y output] [-M MiB] [-j threads] [-q] [-c] [-L] [-t timing] [-g generator] [-s seed] [-n samples] [-a precision] [-b seconds] [-k bytes] [-o format] [-p pivots] [-d distributions] [-w types] [-f leaf sorts] [-z cutoffs] [-l] [-h] [algorithm...]\n"
+		"\t-e: elearning mode, sorts a line of integers read from stdin with the\n"
+		"\t    (single) given algorithm\n"
+		"\t-m: measures the throughput of the min/max and sortedness scans\n"
+		"\t    with every supported instruction set, against memcpy\n"
+		"\t-x: external sort mode, sorts a file of raw 64 bit integers that\n"
+		"\t    may not fit in memory with the (single) given algorithm, and\n"
+		"\t    prints the time spent in I/O and sorting\n"
+		"\t-y: output file of -x (default the input followed by %s)\n"
+		"\t-M: memory held by the elements in -x, in MiB (default %d)\n"
+		"\t-j: number of benchmark points measured in parallel, one per pinned\n"
+		"\t    thread (default 1, 0 uses every available cpu); the parallel\n"
+		"\t    algorithms are always measured one point at a time\n"
+		"\t-q: quiet machine, only use one thread per physical core\n"
+		"\t-c: also measures cycles, instructions, branch misses and L1d and\n"
+		"\t    LLC misses per sort through the hardware counters, if allowed\n"
+		"\t    (not for the parallel algorithms)\n"
+		"\t-L: also sweeps the array length from %llu to %llu elements, one\n"
+		"\t    array at a time with every cpu given to the parallel algorithms\n"
+		"\t-t: subtract (default) times the input generation too and subtracts\n"
+		"\t    its estimate, pool pregenerates the inputs and only times the\n"
+		"\t    sorts\n"
+		"\t-g: generator of the random inputs, xoshiro (default) or pcg\n"
+		"\t-s: base seed of the random inputs (default 0), every benchmark\n"
+		"\t    point derives its own seed from it\n"
+		"\t-n: independent samples measured for every point (default 1), with\n"
+		"\t    their statistics written in the csvs and every sample in\n"
+		"\t    separate .samples.csv files\n"
+		"\t-a: adaptive sampling, samples every point until its confidence\n"
+		"\t    interval is within the given relative precision (e.g. 0.01)\n"
+		"\t-b: time budget of every point with -a, in seconds (default 1)\n"
+		"\t-k: most bytes of counters countingsort_adaptive and every\n"
+		"\t    chunk of countingsort_par allocate before falling back to\n"
+		"\t    radixsort\n"
+		"\t    (default %llu, 0 for no cap)\n"
+		"\t-o: format of the results, csv (default) or binary (.sbr files with\n"
+		"\t    the metadata of the run, see sbr2csv)\n"
+		"\t-p: comma separated pivot strategies (default, median3, ninther,\n"
+		"\t    random or all) of the quicksort based algorithms\n"
+		"\t-d: comma separated input distributions (uniform, sorted, reversed,\n"
+		"\t    organpipe, fewunique, sortedtail, nearlysorted or all), default\n"
+		"\t    uniform\n"
+		"\t-w: comma separated element types (int64, uint64, double, int32,\n"
+		"\t    uint32, float or all) of the algorithms that support them,\n"
+		"\t    default int64\n"
+		"\t-f: comma separated leaf sorts (default, insertion, network, simd\n"
+		"\t    or all) of the partitions of introsort and the quicksorts\n"
+		"\t-z: comma separated cutoffs (2 to %d, default %d) below which the\n"
+		"\t    partitions are sorted by the leaf sorts other than default\n"
+		"\t-l: lists the available algorithms\n"
+		"\t-h: shows this message\n"
+		"Without any algorithm all the default ones are benchmarked.\n",
+		program_name,
+		RUNNER_EXTERNAL_OUTPUT_SUFFIX,
+		RUNNER_EXTERNAL_DEFAULT_MEMORY_BUDGET,
+		(unsigned long long)RUNNER_LARGE_STARTING_ARRAY_LENGTH,
+		(unsigned long long)RUNNER_LARGE_ENDING_ARRAY_LENGTH,
+		(unsigned long long)SORTS_DEFAULT_COUNTING_MEMORY_CAP,
+		SMALLSORT_MAX_LENGTH,
+		SMALLSORT_DEFAULT_CUTOFF
+	);
+}
+
+void print_kernels(void) {
+	for (size_t i = 0; i < g_sort_kernels_count; i += 1) {
+		printf("%-24s %s%s\n",
+			g_sort_kernels[i].name,
+			g_sort_kernels[i].display_name,
+			(g_sort_kernels[i].flags & SORTKERNEL_DEFAULT) ? " (default)" : ""
+		);
+	}
+}
+
+bool parse_pivot_strategies(char* list, Options* options) {
+	options->pivot_strategies_count = 0;
+
+	for (char* name = strtok(list, ","); name != NULL; name = strtok(NULL, ",")) {
+		if (strcmp(name, "all") == 0) {
+			for (size_t i = 0; i < PIVOTSTRATEGY_COUNT; i += 1) {
+				options->pivot_strategies[i] = (Pivot_Strategy)i;
+			}
+			options->pivot_strategies_count = PIVOTSTRATEGY_COUNT;
+			return true;
+		}
+
+		Pivot_Strategy strategy;
+		if (!pivotstrategy_parse(name, &strategy)) {
+			fprintf(stderr, "Unknown pivot strategy %s\n", name);
+			return false;
+		}
+		if (options->pivot_strategies_count == PIVOTSTRATEGY_COUNT) {
+			fprintf(stderr, "Too many pivot strategies\n");
+			return false;
+		}
+
+		options->pivot_strategies[options->pivot_strategies_count] = strategy;
+		options->pivot_strategies_count += 1;
+	}
+
+	return options->pivot_strategies_count > 0;
+}
+
+bool parse_distributions(char* list, Options* options) {
+	options->distributions_count = 0;
+
+	for (char* name = strtok(list, ","); name != NULL; name = strtok(NULL, ",")) {
+		if (strcmp(name, "all") == 0) {
+			for (size_t i = 0; i < RUNNERDISTRIBUTION_COUNT; i += 1) {
+				options->distributions[i] = (Runner_Distribution)i;
+			}
+			options->distributions_count = RUNNERDISTRIBUTION_COUNT;
+			return true;
+		}
+
+		Runner_Distribution distribution;
+		if (!runnerdistribution_parse(name, &distribution)) {
+			fprintf(stderr, "Unknown input distribution %s\n", name);
+			return false;
+		}
+		if (options->distributions_count == RUNNERDISTRIBUTION_COUNT) {
+			fprintf(stderr, "Too many input distributions\n");
+			return false;
+		}
+
+		options->distributions[options->distributions_count] = distribution;
+		options->distributions_count += 1;
+	}
+
+	return options->distributions_count > 0;
+}
+
+bool parse_element_types(char* list, Options* options) {
+	options->element_types_count = 0;
+
+	for (char* name = strtok(list, ","); name != NULL; name = strtok(NULL, ",")) {
+		if (strcmp(name, "all") == 0) {
+			for (size_t i = 0; i < ELEMENTTYPE_COUNT; i += 1) {
+				options->element_types[i] = (Element_Type)i;
+			}
+			options->element_types_count = ELEMENTTYPE_COUNT;
+			return true;
+		}
+
+		Element_Type element_type;
+		if (!elementtype_parse(name, &element_type)) {
+			fprintf(stderr, "Unknown element type %s\n", name);
+			return false;
+		}
+		if (options->element_types_count == ELEMENTTYPE_COUNT) {
+			fprintf(stderr, "Too many element types\n");
+			return false;
+		}
+
+		options->element_types[options->element_types_count] = element_type;
+		options->element_types_count += 1;
+	}
+
+	return options->element_types_count > 0;
+}
+
+bool parse_small_sorts(char* list, Options* options) {
+	options->small_sorts_count = 0;
+
+	for (char* name = strtok(list, ","); name != NULL; name = strtok(NULL, ",")) {
+		if (strcmp(name, "all") == 0) {
+			for (size_t i = 0; i < SMALLSORT_COUNT; i += 1) {
+				options->small_sorts[i] = (Small_Sort)i;
+			}
+			options->small_sorts_count = SMALLSORT_COUNT;
+			return true;
+		}
+
+		Small_Sort small_sort;
+		if (!smallsort_parse(name, &small_sort)) {
+			fprintf(stderr, "Unknown leaf sort %s\n", name);
+			return false;
+		}
+		if (options->small_sorts_count == SMALLSORT_COUNT) {
+			fprintf(stderr, "Too many leaf sorts\n");
+			return false;
+		}
+
+		options->small_sorts[options->small_sorts_count] = small_sort;
+		options->small_sorts_count += 1;
+	}
+
+	return options->small_sorts_count > 0;
+}
+
+bool parse_small_sort_cutoffs(char* list, Options* options) {
+	options->small_sort_cutoffs_count = 0;
+
+	for (char* value = strtok(list, ","); value != NULL; value = strtok(NULL, ",")) {
+		char* value_end;
+		size_t cutoff = strtoul(value, &value_end, 10);
+		if (*value_end != '\0' || cutoff < 2 || cutoff > SMALLSORT_MAX_LENGTH) {
+			fprintf(stderr, "Invalid leaf sort cutoff %s\n", value);
+			return false;
+		}
+		if (options->small_sort_cutoffs_count == SMALLSORT_MAX_LENGTH) {
+			fprintf(stderr, "Too many leaf sort cutoffs\n");
+			return false;
+		}
+
+		options->small_sort_cutoffs[options->small_sort_cutoffs_count] = cutoff;
+		options->small_sort_cutoffs_count += 1;
+	}
+
+	return options->small_sort_cutoffs_count > 0;
+}
+
+bool parse_options(int argc, char** argv, Options* options) {
+	options->mode = RUNNERMODE_BENCHMARK;
+	options->kernels_count = 0;
+	options->pivot_strategies[0] = PIVOTSTRATEGY_DEFAULT;
+	options->pivot_strategies_count = 1;
+	options->distributions[0] = RUNNERDISTRIBUTION_UNIFORM;
+	options->distributions_count = 1;
+	options->element_types[0] = ELEMENTTYPE_INT64;
+	options->element_types_count = 1;
+	options->small_sorts[0] = SMALLSORT_DEFAULT;
+	options->small_sorts_count = 1;
+	options->small_sort_cutoffs[0] = SMALLSORT_DEFAULT_CUTOFF;
+	options->small_sort_cutoffs_count = 1;
+	options->runner_options.thread_count = 1;
+	options->runner_options.physical_cores_only = false;
+	options->runner_options.hardware_counters = false;
+	options->runner_options.large_array_lengths = false;
+	options->runner_options.timing = RUNNERTIMING_SUBTRACT_INIT;
+	options->runner_options.generator = RUNNERGENERATOR_XOSHIRO;
+	options->runner_options.seed = 0;
+	options->runner_options.sample_count = 1;
+	options->runner_options.target_precision = 0.0;
+	options->runner_options.point_time_budget = RUNNER_DEFAULT_POINT_TIME_BUDGET;
+	options->runner_options.output_format = RUNNEROUTPUTFORMAT_CSV;
+	options->external_options.input_path = NULL;
+	options->external_options.output_path = NULL;
+	options->external_options.memory_budget = (size_t)RUNNER_EXTERNAL_DEFAULT_MEMORY_BUDGET << 20;
+
+	int option;
+	char* option_end;
+	while ((option = getopt(argc, argv, "emx:y:M:j:qcLt:g:s:n:a:b:k:o:p:d:w:f:z:lh")) != -1) {
+		switch (option) {
+		case 'e':
+			options->mode = RUNNERMODE_ELEARNING; break;
+		case 'm':
+			options->mode = RUNNERMODE_SCAN; break;
+		case 'x':
+			options->mode = RUNNERMODE_EXTERNAL;
+			options->external_options.input_path = optarg;
+			break;
+		case 'y':
+			options->external_options.output_path = optarg; break;
+		case 'M':
+			options->external_options.memory_budget = (size_t)strtoull(optarg, &option_end, 10) << 20;
+			if (*optarg == '\0' || *option_end != '\0') {
+				fprintf(stderr, "Invalid memory budget %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'j':
+			options->runner_options.thread_count = strtoul(optarg, &option_end, 10);
+			if (*optarg == '\0' || *option_end != '\0') {
+				fprintf(stderr, "Invalid thread count %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'q':
+			options->runner_options.physical_cores_only = true; break;
+		case 'c':
+			options->runner_options.hardware_counters = true; break;
+		case 'L':
+			options->runner_options.large_array_lengths = true; break;
+		case 't':
+			if (!runnertiming_parse(optarg, &options->runner_options.timing)) {
+				fprintf(stderr, "Unknown timing %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'g':
+			if (!runnergenerator_parse(optarg, &options->runner_options.generator)) {
+				fprintf(stderr, "Unknown generator %s\n", optarg);
+				return false;
+			}
+			break;
+		case 's':
+			options->runner_options.seed = strtoull(optarg, &option_end, 10);
+			if (*optarg == '\0' || *option_end != '\0') {
+				fprintf(stderr, "Invalid seed %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'n':
+			options->runner_options.sample_count = strtoul(optarg, &option_end, 10);
+			if (*optarg == '\0' || *option_end != '\0' || options->runner_options.sample_count == 0) {
+				fprintf(stderr, "Invalid sample count %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'a':
+			options->runner_options.target_precision = strtod(optarg, &option_end);
+			if (*optarg == '\0' || *option_end != '\0' || !(options->runner_options.target_precision > 0.0)) {
+				fprintf(stderr, "Invalid precision %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'b':
+			options->runner_options.point_time_budget = strtod(optarg, &option_end);
+			if (*optarg == '\0' || *option_end != '\0' || !(options->runner_options.point_time_budget > 0.0)) {
+				fprintf(stderr, "Invalid time budget %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'k':
+			sorts_set_counting_memory_cap(strtoull(optarg, &option_end, 10));
+			if (*optarg == '\0' || *option_end != '\0') {
+				fprintf(stderr, "Invalid memory cap %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'o':
+			if (!runneroutputformat_parse(optarg, &options->runner_options.output_format)) {
+				fprintf(stderr, "Unknown output format %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'p':
+			if (!parse_pivot_strategies(optarg, options)) {
+				return false;
+			}
+			break;
+		case 'd':
+			if (!parse_distributions(optarg, options)) {
+				return false;
+			}
+			break;
+		case 'w':
+			if (!parse_element_types(optarg, options)) {
+				return false;
+			}
+			break;
+		case 'f':
+			if (!parse_small_sorts(optarg, options)) {
+				return false;
+			}
+			break;
+		case 'z':
+			if (!parse_small_sort_cutoffs(optarg, options)) {
+				return false;
+			}
+			break;
+		case 'l':
+			print_kernels(); exit(EXIT_SUCCESS);
+		case 'h':
+			print_usage(argv[0]); exit(EXIT_SUCCESS);
+		default:
+			return false;
+		}
+	}
+
+	for (int i = optind; i < argc; i += 1) {
+		const Sort_Kernel* kernel = sortkernel_find(argv[i]);
+		if (kernel == NULL) {
+			fprintf(stderr, "Unknown algorithm %s (use -l to list them)\n", argv[i]);
+			return false;
+		}
+		if (options->kernels_count == sizeof(options->kernels) / sizeof(options->kernels[0])) {
+			fprintf(stderr, "Too many algorithms\n");
+			return false;
+		}
+
+		options->kernels[options->kernels_count] = kernel;
+		options->kernels_count += 1;
+	}
+
+	if (options->kernels_count == 0) {
+		if (options->mode == RUNNERMODE_ELEARNING) {
+			fprintf(stderr, "The elearning mode requires an algorithm\n");
+			return false;
+		}
+		if (options->mode == RUNNERMODE_EXTERNAL) {
+			fprintf(stderr, "The external sort mode requires an algorithm\n");
+			return false;
+		}
+
+		for (size_t i = 0; i < g_sort_kernels_count; i += 1) {
+			if (g_sort_kernels[i].flags & SORTKERNEL_DEFAULT) {
+				options->kernels[options->kernels_count] = &g_sort_kernels[i];
+				options->kernels_count += 1;
+			}
+		}
+	}
+	if (options->mode == RUNNERMODE_ELEARNING && options->kernels_count != 1) {
+		fprintf(stderr, "The elearning mode requires exactly one algorithm\n");
+		return false;
+	}
+	if (options->mode == RUNNERMODE_ELEARNING && (options->kernels[0]->flags & SORTKERNEL_RECORDS)) {
+		fprintf(stderr, "The elearning mode requires an algorithm sorting integers\n");
+		return false;
+	}
+	if (options->mode == RUNNERMODE_EXTERNAL && options->kernels_count != 1) {
+		fprintf(stderr, "The external sort mode requires exactly one algorithm\n");
+		return false;
+	}
+	if (options->mode == RUNNERMODE_EXTERNAL && (options->kernels[0]->flags & SORTKERNEL_RECORDS)) {
+		fprintf(stderr, "The external sort mode requires an algorithm sorting integers\n");
+		return false;
+	}
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MAIN
+////////////////////////////////////////////////////////////////////////////////
+
+void run_benchmark_mode(const Options* options) {
+	runner_init(&options->runner_options);
+
+	for (size_t i = 0; i < options->kernels_count; i += 1) {
+		const Sort_Kernel* kernel = options->kernels[i];
+
+		// Kernels that do not choose a pivot are only benchmarked once
+		size_t pivot_strategies_count = options->pivot_strategies_count;
+		if (!(kernel->flags & SORTKERNEL_PIVOT_STRATEGY)) {
+			pivot_strategies_count = 1;
+		}
+
+		// and the ones that only sort int64_t only as int64_t
+		size_t element_types_count = options->element_types_count;
+		if (!(kernel->flags & SORTKERNEL_ELEMENT_TYPES)) {
+			element_types_count = 1;
+		}
+
+		// and the ones without a leaf sort only with their own
+		size_t small_sorts_count = options->small_sorts_count;
+		if (!(kernel->flags & SORTKERNEL_SMALL_SORT)) {
+			small_sorts_count = 1;
+		}
+
+		for (size_t j = 0; j < pivot_strategies_count; j += 1) {
+			sorts_set_pivot_strategy(options->pivot_strategies[j]);
+
+			for (size_t m = 0; m < small_sorts_count; m += 1) {
+				Small_Sort small_sort = options->small_sorts[m];
+				if (!(kernel->flags & SORTKERNEL_SMALL_SORT)) {
+					small_sort = SMALLSORT_DEFAULT;
+				}
+
+				// The cutoff of the default leaf sort is fixed by every kernel
+				size_t cutoffs_count = options->small_sort_cutoffs_count;
+				if (small_sort == SMALLSORT_DEFAULT) {
+					cutoffs_count = 1;
+				}
+
+				for (size_t n = 0; n < cutoffs_count; n += 1) {
+					sorts_set_small_sort(small_sort, options->small_sort_cutoffs[n]);
+
+					for (size_t k = 0; k < options->distributions_count; k += 1) {
+						for (size_t l = 0; l < element_types_count; l += 1) {
+							Element_Type element_type = options->element_types[l];
+							if (!(kernel->flags & SORTKERNEL_ELEMENT_TYPES)) {
+								element_type = ELEMENTTYPE_INT64;
+							}
+							runner_benchmark_kernel(kernel, options->distributions[k], element_type);
+						}
+					}
+				}
+			}
+		}
+	}
+	printf("Benchmark finished!\n");
+
+	runner_terminate();
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parse_options(argc, argv, &options)) {
+		print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	switch (options.mode) {
+	case RUNNERMODE_BENCHMARK:
+		run_benchmark_mode(&options); break;
+	case RUNNERMODE_ELEARNING:
+		sorts_set_pivot_strategy(options.pivot_strategies[0]);
+		sorts_set_small_sort(options.small_sorts[0], options.small_sort_cutoffs[0]);
+		run_elearning_mode(options.kernels[0]); break;
+	case RUNNERMODE_SCAN:
+		run_scan_benchmark_mode(); break;
+	case RUNNERMODE_EXTERNAL:
+		sorts_set_pivot_strategy(options.pivot_strategies[0]);
+		sorts_set_small_sort(options.small_sorts[0], options.small_sort_cutoffs[0]);
+		if (!run_external_mode(options.kernels[0], &options.external_options)) {
+			return EXIT_FAILURE;
+		}
+		break;
+	}
+
+	return EXIT_SUCCESS;
+}
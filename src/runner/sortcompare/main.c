@@ -0,0 +1,473 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "harness/runner.h"
+
+// Compares two results directories (such as results/runner_Linux_x86_64 and
+// results) point by point, and exits with COMPARE_EXIT_REGRESSION when some
+// kernel got significantly slower than the threshold
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CONFIG
+////////////////////////////////////////////////////////////////////////////////
+
+#define COMPARE_DEFAULT_THRESHOLD 0.05
+#define COMPARE_DEFAULT_SIGNIFICANCE 0.01
+#define COMPARE_MAX_FILES 1024
+#define COMPARE_MAX_PATH 1024
+
+// Columns of the point tables, see g_point_columns in benchmark.c. Results
+// written before the confidence intervals only have the first two.
+#define COMPARE_X_COLUMN 0
+#define COMPARE_TIME_COLUMN 1
+#define COMPARE_CI_LOW_COLUMN 15
+#define COMPARE_CI_HIGH_COLUMN 16
+
+#define COMPARE_EXIT_SUCCESS 0
+#define COMPARE_EXIT_REGRESSION 1
+#define COMPARE_EXIT_ERROR 2
+
+
+////////////////////////////////////////////////////////////////////////////////
+// RESULTS TABLES
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	uint64_t x;
+	double time;
+	// NAN when the results have no confidence interval
+	double ci_low;
+	double ci_high;
+} Compare_Point;
+
+typedef struct {
+	Compare_Point* points;
+	size_t points_count;
+	size_t points_capacity;
+} Compare_Table;
+
+void comparetable_push(Compare_Table* table, const Compare_Point* point) {
+	if (table->points_count == table->points_capacity) {
+		table->points_capacity = table->points_capacity > 0 ? table->points_capacity * 2 : 256;
+		table->points = realloc(table->points, sizeof(Compare_Point) * table->points_capacity);
+		if (table->points == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			exit(COMPARE_EXIT_ERROR);
+		}
+	}
+
+	table->points[table->points_count] = *point;
+	table->points_count += 1;
+}
+
+bool has_suffix(const char* string, const char* suffix) {
+	size_t string_length = strlen(string);
+	size_t suffix_length = strlen(suffix);
+
+	return string_length >= suffix_length && strcmp(string + string_length - suffix_length, suffix) == 0;
+}
+
+bool read_csv_table(const char* path, Compare_Table* table) {
+	FILE* file = fopen(path, "r");
+	if (file == NULL) {
+		return false;
+	}
+
+	char line[4096];
+	while (fgets(line, sizeof(line), file) != NULL) {
+		double values[RUNNER_RESULTS_MAX_COLUMNS];
+		size_t values_count = 0;
+
+		char* cursor = line;
+		while (values_count < RUNNER_RESULTS_MAX_COLUMNS) {
+			char* end;
+			double value = strtod(cursor, &end);
+			if (end == cursor) {
+				break;
+			}
+
+			values[values_count] = value;
+			values_count += 1;
+
+			cursor = strchr(end, ',');
+			if (cursor == NULL) {
+				break;
+			}
+			cursor += 1;
+		}
+		if (values_count < 2) {
+			continue;
+		}
+
+		Compare_Point point;
+		point.x = (uint64_t)values[COMPARE_X_COLUMN];
+		point.time = values[COMPARE_TIME_COLUMN];
+		point.ci_low = values_count > COMPARE_CI_HIGH_COLUMN ? values[COMPARE_CI_LOW_COLUMN] : NAN;
+		point.ci_high = values_count > COMPARE_CI_HIGH_COLUMN ? values[COMPARE_CI_HIGH_COLUMN] : NAN;
+		comparetable_push(table, &point);
+	}
+
+	fclose(file);
+	return true;
+}
+
+bool read_binary_table(const char* path, Compare_Table* table) {
+	Runner_Results results;
+	if (!runnerresults_open(&results, path)) {
+		return false;
+	}
+
+	Runner_Value values[RUNNER_RESULTS_MAX_COLUMNS];
+	while (runnerresults_read(&results, values)) {
+		Compare_Point point;
+		point.x = values[COMPARE_X_COLUMN].u64;
+		point.time = values[COMPARE_TIME_COLUMN].f64;
+		point.ci_low = results.columns_count > COMPARE_CI_HIGH_COLUMN ? values[COMPARE_CI_LOW_COLUMN].f64 : NAN;
+		point.ci_high = results.columns_count > COMPARE_CI_HIGH_COLUMN ? values[COMPARE_CI_HIGH_COLUMN].f64 : NAN;
+		comparetable_push(table, &point);
+	}
+
+	runnerresults_close(&results);
+	return true;
+}
+
+bool read_table(const char* path, Compare_Table* table) {
+	table->points = NULL;
+	table->points_count = 0;
+	table->points_capacity = 0;
+
+	if (has_suffix(path, RUNNER_BINARY_EXTENSION)) {
+		return read_binary_table(path, table);
+	}
+	return read_csv_table(path, table);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// STATISTICS
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	size_t points_count;
+	double geometric_mean_ratio; // candidate time / baseline time
+	double min_ratio;
+	double max_ratio;
+	// Points whose confidence intervals do not overlap, when both results
+	// have them
+	size_t significantly_slower;
+	size_t significantly_faster;
+	// One sided p-values of the Wilcoxon signed rank test on the log ratios
+	double p_slower;
+	double p_faster;
+} Compare_Result;
+
+int compare_absolute(const void* a, const void* b) {
+	double x = fabs(*(const double*)a);
+	double y = fabs(*(const double*)b);
+
+	return (x > y) - (x < y);
+}
+
+double normal_upper_tail(double z) {
+	return 0.5 * erfc(z / sqrt(2.0));
+}
+
+// Wilcoxon signed rank test with the normal approximation, fine for the
+// hundreds of points of every sweep. differences is reordered.
+void wilcoxon_signed_rank(double* differences, size_t count, double* p_positive, double* p_negative) {
+	// Zero differences carry no sign and are dropped
+	size_t nonzero_count = 0;
+	for (size_t i = 0; i < count; i += 1) {
+		if (differences[i] != 0.0) {
+			differences[nonzero_count] = differences[i];
+			nonzero_count += 1;
+		}
+	}
+
+	*p_positive = 1.0;
+	*p_negative = 1.0;
+	if (nonzero_count == 0) {
+		return;
+	}
+
+	qsort(differences, nonzero_count, sizeof(double), compare_absolute);
+
+	double positive_rank_sum = 0.0;
+	double tie_correction = 0.0;
+	size_t i = 0;
+	while (i < nonzero_count) {
+		size_t j = i + 1;
+		while (j < nonzero_count && fabs(differences[j]) == fabs(differences[i])) {
+			j += 1;
+		}
+
+		// Tied absolute values share the average of their ranks
+		double rank = (double)(i + 1 + j) / 2.0;
+		for (size_t k = i; k < j; k += 1) {
+			if (differences[k] > 0.0) {
+				positive_rank_sum += rank;
+			}
+		}
+
+		double ties = (double)(j - i);
+		tie_correction += ties * ties * ties - ties;
+		i = j;
+	}
+
+	double n = (double)nonzero_count;
+	double mean = n * (n + 1.0) / 4.0;
+	double variance = n * (n + 1.0) * (2.0 * n + 1.0) / 24.0 - tie_correction / 48.0;
+	if (variance <= 0.0) {
+		return;
+	}
+
+	double deviation = sqrt(variance);
+	*p_positive = normal_upper_tail((positive_rank_sum - mean - 0.5) / deviation);
+	*p_negative = normal_upper_tail((mean - positive_rank_sum - 0.5) / deviation);
+}
+
+bool compare_tables(const Compare_Table* baseline, const Compare_Table* candidate, Compare_Result* result) {
+	size_t count = baseline->points_count < candidate->points_count ? baseline->points_count : candidate->points_count;
+
+	double* log_ratios = malloc(sizeof(double) * (count > 0 ? count : 1));
+	if (log_ratios == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		exit(COMPARE_EXIT_ERROR);
+	}
+
+	result->points_count = 0;
+	result->min_ratio = INFINITY;
+	result->max_ratio = 0.0;
+	result->significantly_slower = 0;
+	result->significantly_faster = 0;
+
+	double log_ratio_sum = 0.0;
+	for (size_t i = 0; i < count; i += 1) {
+		const Compare_Point* old_point = &baseline->points[i];
+		const Compare_Point* new_point = &candidate->points[i];
+
+		// The sweeps are deterministic, so the points are aligned by position
+		if (old_point->x != new_point->x) {
+			free(log_ratios);
+			return false;
+		}
+		if (!(old_point->time > 0.0) || !(new_point->time > 0.0)) {
+			continue;
+		}
+
+		double ratio = new_point->time / old_point->time;
+		log_ratios[result->points_count] = log(ratio);
+		log_ratio_sum += log(ratio);
+		result->points_count += 1;
+
+		if (ratio < result->min_ratio) {
+			result->min_ratio = ratio;
+		}
+		if (ratio > result->max_ratio) {
+			result->max_ratio = ratio;
+		}
+
+		if (new_point->ci_low > old_point->ci_high) {
+			result->significantly_slower += 1;
+		} else if (new_point->ci_high < old_point->ci_low) {
+			result->significantly_faster += 1;
+		}
+	}
+
+	result->geometric_mean_ratio = result->points_count > 0 ? exp(log_ratio_sum / (double)result->points_count) : NAN;
+	wilcoxon_signed_rank(log_ratios, result->points_count, &result->p_slower, &result->p_faster);
+
+	free(log_ratios);
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MAIN
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	double threshold;
+	double significance;
+	const char* baseline_directory;
+	const char* candidate_directory;
+} Options;
+
+void print_usage(const char* program_name) {
+	fprintf(stderr,
+		"Usage: %s [-t threshold] [-a significance] baseline_dir candidate_dir\n"
+		"\t-t: relative slowdown of the geometric mean time tolerated before a\n"
+		"\t    kernel counts as regressed (default %g)\n"
+		"\t-a: significance level of the signed rank test (default %g)\n"
+		"Compares every results file (.csv or .sbr) present in both directories\n"
+		"point by point. Exits with %d if some kernel regressed, %d on errors.\n",
+		program_name,
+		COMPARE_DEFAULT_THRESHOLD,
+		COMPARE_DEFAULT_SIGNIFICANCE,
+		COMPARE_EXIT_REGRESSION,
+		COMPARE_EXIT_ERROR
+	);
+}
+
+bool parse_options(int argc, char** argv, Options* options) {
+	options->threshold = COMPARE_DEFAULT_THRESHOLD;
+	options->significance = COMPARE_DEFAULT_SIGNIFICANCE;
+
+	int option;
+	char* option_end;
+	while ((option = getopt(argc, argv, "t:a:h")) != -1) {
+		switch (option) {
+		case 't':
+			options->threshold = strtod(optarg, &option_end);
+			if (*optarg == '\0' || *option_end != '\0' || !(options->threshold >= 0.0)) {
+				fprintf(stderr, "Invalid threshold %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'a':
+			options->significance = strtod(optarg, &option_end);
+			if (*optarg == '\0' || *option_end != '\0' || !(options->significance > 0.0 && options->significance < 1.0)) {
+				fprintf(stderr, "Invalid significance %s\n", optarg);
+				return false;
+			}
+			break;
+		case 'h':
+			print_usage(argv[0]); exit(COMPARE_EXIT_SUCCESS);
+		default:
+			return false;
+		}
+	}
+
+	if (argc - optind != 2) {
+		return false;
+	}
+	options->baseline_directory = argv[optind];
+	options->candidate_directory = argv[optind + 1];
+
+	return true;
+}
+
+int compare_names(const void* a, const void* b) {
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Lists the point tables of the directory, sorted by name
+size_t list_result_files(const char* directory, char** names, size_t names_capacity) {
+	DIR* dir = opendir(directory);
+	if (dir == NULL) {
+		fprintf(stderr, "Could not open %s\n", directory);
+		exit(COMPARE_EXIT_ERROR);
+	}
+
+	size_t names_count = 0;
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL && names_count < names_capacity) {
+		const char* name = entry->d_name;
+		bool is_results = has_suffix(name, RUNNER_CSV_EXTENSION) || has_suffix(name, RUNNER_BINARY_EXTENSION);
+		bool is_samples = strstr(name, ".samples.") != NULL;
+		if (!is_results || is_samples) {
+			continue;
+		}
+
+		names[names_count] = strdup(name);
+		names_count += 1;
+	}
+	closedir(dir);
+
+	qsort(names, names_count, sizeof(char*), compare_names);
+	return names_count;
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parse_options(argc, argv, &options)) {
+		print_usage(argv[0]);
+		return COMPARE_EXIT_ERROR;
+	}
+
+	static char* names[COMPARE_MAX_FILES];
+	size_t names_count = list_result_files(options.baseline_directory, names, COMPARE_MAX_FILES);
+
+	printf("%-48s %6s %9s %9s %9s %7s %7s %10s %10s  %s\n",
+		"results", "points", "speedup", "min", "max", "slower", "faster", "p(slower)", "p(faster)", "verdict"
+	);
+
+	size_t compared_count = 0;
+	size_t regressions_count = 0;
+	bool failed = false;
+	for (size_t i = 0; i < names_count; i += 1) {
+		char baseline_path[COMPARE_MAX_PATH];
+		char candidate_path[COMPARE_MAX_PATH];
+		snprintf(baseline_path, sizeof(baseline_path), "%s/%s", options.baseline_directory, names[i]);
+		snprintf(candidate_path, sizeof(candidate_path), "%s/%s", options.candidate_directory, names[i]);
+
+		Compare_Table baseline;
+		Compare_Table candidate;
+		if (access(candidate_path, R_OK) != 0) {
+			free(names[i]);
+			continue;
+		}
+		if (!read_table(baseline_path, &baseline) || !read_table(candidate_path, &candidate)) {
+			fprintf(stderr, "Could not read %s\n", names[i]);
+			failed = true;
+			free(names[i]);
+			continue;
+		}
+
+		Compare_Result result;
+		if (!compare_tables(&baseline, &candidate, &result)) {
+			fprintf(stderr, "%s: the points of the two results do not match\n", names[i]);
+			failed = true;
+		} else {
+			const char* verdict = "same";
+			bool slower = result.p_slower < options.significance && result.geometric_mean_ratio > 1.0;
+			bool faster = result.p_faster < options.significance && result.geometric_mean_ratio < 1.0;
+			if (slower && result.geometric_mean_ratio > 1.0 + options.threshold) {
+				verdict = "REGRESSION";
+				regressions_count += 1;
+			} else if (slower) {
+				verdict = "slower";
+			} else if (faster) {
+				verdict = "faster";
+			}
+
+			// Speedup of the candidate, > 1 when it is faster
+			printf("%-48s %6llu %9.4f %9.4f %9.4f %7llu %7llu %10.2e %10.2e  %s\n",
+				names[i],
+				(unsigned long long)result.points_count,
+				1.0 / result.geometric_mean_ratio,
+				1.0 / result.max_ratio,
+				1.0 / result.min_ratio,
+				(unsigned long long)result.significantly_slower,
+				(unsigned long long)result.significantly_faster,
+				result.p_slower,
+				result.p_faster,
+				verdict
+			);
+			compared_count += 1;
+		}
+
+		free(baseline.points);
+		free(candidate.points);
+		free(names[i]);
+	}
+
+	printf("\n%llu results compared, %llu regressed by more than %.1f%%\n",
+		(unsigned long long)compared_count,
+		(unsigned long long)regressions_count,
+		options.threshold * 100.0
+	);
+
+	if (failed) {
+		return COMPARE_EXIT_ERROR;
+	}
+	return regressions_count > 0 ? COMPARE_EXIT_REGRESSION : COMPARE_EXIT_SUCCESS;
+}
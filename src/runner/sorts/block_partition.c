@@ -0,0 +1,159 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sorts/partition.h"
+
+static void swap(int64_t* a, int64_t* b) {
+	int64_t t = *a;
+	*a = *b;
+	*b = t;
+}
+
+static size_t min_size(size_t a, size_t b) {
+	return a < b ? a : b;
+}
+
+// Swaps count pairs of misplaced elements, first[offsets_left[i]] with
+// last[-offsets_right[i]]. When the two blocks do not have the same number of
+// misplaced elements a cyclic permutation is used instead, which needs one
+// less move per pair.
+static void swap_offsets(int64_t* first, int64_t* last, unsigned char* offsets_left, unsigned char* offsets_right, size_t count, bool use_swaps) {
+	if (use_swaps) {
+		for (size_t i = 0; i < count; i += 1) {
+			swap(first + offsets_left[i], last - offsets_right[i]);
+		}
+	} else if (count > 0) {
+		int64_t* left = first + offsets_left[0];
+		int64_t* right = last - offsets_right[0];
+		int64_t tmp = *left;
+		*left = *right;
+
+		for (size_t i = 1; i < count; i += 1) {
+			left = first + offsets_left[i];
+			*right = *left;
+			right = last - offsets_right[i];
+			*left = *right;
+		}
+		*right = tmp;
+	}
+}
+
+size_t block_partition(int64_t* array, size_t array_length) {
+	if (array_length < 2) {
+		return 0;
+	}
+
+	int64_t pivot = array[array_length - 1];
+
+	// [first, last) is the part not yet partitioned
+	int64_t* first = array;
+	int64_t* last = array + array_length - 1;
+
+	// offsets_left holds the positions (from first) of the elements that must go
+	// right, offsets_right the positions (from last, 1 based) of the elements
+	// that must go left
+	unsigned char offsets_left[BLOCK_PARTITION_BLOCK_SIZE];
+	unsigned char offsets_right[BLOCK_PARTITION_BLOCK_SIZE];
+	size_t left_count = 0;
+	size_t right_count = 0;
+	size_t left_start = 0;
+	size_t right_start = 0;
+
+	while (last - first > 2 * BLOCK_PARTITION_BLOCK_SIZE) {
+		if (left_count == 0) {
+			left_start = 0;
+			for (size_t i = 0; i < BLOCK_PARTITION_BLOCK_SIZE; i += 1) {
+				offsets_left[left_count] = (unsigned char)i;
+				left_count += !(first[i] < pivot);
+			}
+		}
+		if (right_count == 0) {
+			right_start = 0;
+			for (size_t i = 1; i <= BLOCK_PARTITION_BLOCK_SIZE; i += 1) {
+				offsets_right[right_count] = (unsigned char)i;
+				right_count += last[-(ptrdiff_t)i] < pivot;
+			}
+		}
+
+		size_t count = min_size(left_count, right_count);
+		swap_offsets(first, last, offsets_left + left_start, offsets_right + right_start, count, left_count == right_count);
+		left_count -= count;
+		right_count -= count;
+		left_start += count;
+		right_start += count;
+
+		if (left_count == 0) {
+			first += BLOCK_PARTITION_BLOCK_SIZE;
+		}
+		if (right_count == 0) {
+			last -= BLOCK_PARTITION_BLOCK_SIZE;
+		}
+	}
+
+	// At most one block still has misplaced elements, the unknown elements left
+	// are given to the other block (or split between the two)
+	size_t left_size;
+	size_t right_size;
+	size_t unknown_count = (size_t)(last - first) - ((left_count != 0 || right_count != 0) ? BLOCK_PARTITION_BLOCK_SIZE : 0);
+	if (right_count != 0) {
+		left_size = unknown_count;
+		right_size = BLOCK_PARTITION_BLOCK_SIZE;
+	} else if (left_count != 0) {
+		left_size = BLOCK_PARTITION_BLOCK_SIZE;
+		right_size = unknown_count;
+	} else {
+		left_size = unknown_count / 2;
+		right_size = unknown_count - left_size;
+	}
+
+	if (unknown_count != 0 && left_count == 0) {
+		left_start = 0;
+		for (size_t i = 0; i < left_size; i += 1) {
+			offsets_left[left_count] = (unsigned char)i;
+			left_count += !(first[i] < pivot);
+		}
+	}
+	if (unknown_count != 0 && right_count == 0) {
+		right_start = 0;
+		for (size_t i = 1; i <= right_size; i += 1) {
+			offsets_right[right_count] = (unsigned char)i;
+			right_count += last[-(ptrdiff_t)i] < pivot;
+		}
+	}
+
+	size_t count = min_size(left_count, right_count);
+	swap_offsets(first, last, offsets_left + left_start, offsets_right + right_start, count, left_count == right_count);
+	left_count -= count;
+	right_count -= count;
+	left_start += count;
+	right_start += count;
+
+	if (left_count == 0) {
+		first += left_size;
+	}
+	if (right_count == 0) {
+		last -= right_size;
+	}
+
+	// Only one block is left and [first, last) is exactly that block: its
+	// misplaced elements are moved to its far end
+	if (left_count != 0) {
+		while (left_count > 0) {
+			left_count -= 1;
+			last -= 1;
+			swap(first + offsets_left[left_start + left_count], last);
+		}
+		first = last;
+	}
+	if (right_count != 0) {
+		while (right_count > 0) {
+			right_count -= 1;
+			swap(last - offsets_right[right_start + right_count], first);
+			first += 1;
+		}
+	}
+
+	swap(first, &array[array_length - 1]);
+	return (size_t)(first - array);
+}
@@ -0,0 +1,471 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "sorts/sorts.h"
+#include "sorts/scratch.h"
+#include "sorts/stats.h"
+#include "sorts/scan.h"
+#include "sorts/task_pool.h"
+
+// Sub-histograms of countingsort_multi, element i is counted in the
+// (i % COUNTINGSORT_HISTOGRAMS)-th one
+#define COUNTINGSORT_HISTOGRAMS 4
+// Beyond this size the sub-histograms stop fitting in the L2 cache and cost
+// more in misses than they save, so countingsort_multi counts in one
+#define COUNTINGSORT_MULTI_MAX_HISTOGRAMS_SIZE (256 << 10)
+// Smallest chunk given to a thread by countingsort_parallel, small enough for
+// the 10000 elements of the input range axis to be split in two
+#define COUNTINGSORT_PARALLEL_MIN_CHUNK_LENGTH 4096
+
+// Defines a countingsort_with_buffers function with the given counter type,
+// which must hold array_length
+#define COUNTINGSORT_DEFINE_WITH_BUFFERS(function_name, Counter) \
+	static void function_name(int64_t* array, size_t array_length, int64_t min_array_element, size_t element_count, Counter* counts_array, int64_t* results_array) { \
+		memset(counts_array, 0, element_count * sizeof(Counter)); \
+		\
+		for (size_t i = 0; i < array_length; i += 1) { \
+			int64_t key = array[i] - min_array_element; \
+			counts_array[key] += 1; \
+		} \
+		\
+		for (size_t i = 1; i < element_count; i += 1) { \
+			counts_array[i] += counts_array[i - 1]; \
+		} \
+		\
+		for (size_t ii = array_length; ii > 0; ii -= 1) { \
+			size_t i = ii - 1; \
+			\
+			int64_t key = array[i] - min_array_element; \
+			counts_array[key] -= 1; \
+			results_array[counts_array[key]] = array[i]; \
+		} \
+		\
+		memcpy(array, results_array, array_length * sizeof(int64_t)); \
+	}
+
+COUNTINGSORT_DEFINE_WITH_BUFFERS(countingsort_with_buffers, uint64_t)
+COUNTINGSORT_DEFINE_WITH_BUFFERS(countingsort_with_buffers_32, uint32_t)
+COUNTINGSORT_DEFINE_WITH_BUFFERS(countingsort_with_buffers_16, uint16_t)
+
+static size_t g_counting_memory_cap = SORTS_DEFAULT_COUNTING_MEMORY_CAP;
+
+void sorts_set_counting_memory_cap(size_t bytes) {
+	g_counting_memory_cap = bytes;
+}
+
+size_t sorts_counting_memory_cap(void) {
+	return g_counting_memory_cap;
+}
+
+void countingsort(int64_t* array, size_t array_length) {
+	if (array_length < 2) {
+		return;
+	}
+
+	int64_t max_array_element;
+	int64_t min_array_element;
+	scan_min_max(array, array_length, &min_array_element, &max_array_element);
+
+	size_t element_count = max_array_element - min_array_element + 1;
+	uint64_t* counts_array = malloc(element_count * sizeof(uint64_t));
+	int64_t* results_array = malloc(array_length * sizeof(int64_t));
+	sortstats_record_allocations(2);
+	sortstats_record_bytes(element_count * sizeof(uint64_t) + array_length * sizeof(int64_t));
+
+	countingsort_with_buffers(array, array_length, min_array_element, element_count, counts_array, results_array);
+
+	free(counts_array);
+	free(results_array);
+}
+
+void countingsort_scratch(int64_t* array, size_t array_length, Scratch_Arena* scratch) {
+	if (array_length < 2) {
+		return;
+	}
+
+	int64_t max_array_element;
+	int64_t min_array_element;
+	scan_min_max(array, array_length, &min_array_element, &max_array_element);
+
+	// Unsigned and compared before adding 1, as for countingsort_adaptive, but
+	// without its memory cap
+	uint64_t element_range = (uint64_t)max_array_element - (uint64_t)min_array_element;
+	if (element_range >= SIZE_MAX / sizeof(uint64_t)) {
+		radixsort(array, array_length);
+		return;
+	}
+
+	size_t element_count = (size_t)element_range + 1;
+	uint64_t* counts_array = scratcharena_alloc(scratch, element_count * sizeof(uint64_t));
+	int64_t* results_array = scratcharena_alloc(scratch, array_length * sizeof(int64_t));
+
+	countingsort_with_buffers(array, array_length, min_array_element, element_count, counts_array, results_array);
+
+	scratcharena_reset(scratch);
+}
+
+void countingsort_arena(int64_t* array, size_t array_length) {
+	countingsort_scratch(array, array_length, sorts_thread_scratch());
+}
+
+// The counters only have to hold array_length, so small arrays get narrower
+// ones: at input range 1000000 and 10000 elements the counts take 2 MB instead
+// of 8 MB. Counts that would still go beyond sorts_counting_memory_cap() are
+// not allocated at all and the array is radix sorted instead.
+void countingsort_adaptive(int64_t* array, size_t array_length) {
+	if (array_length < 2) {
+		return;
+	}
+
+	int64_t max_array_element;
+	int64_t min_array_element;
+	scan_min_max(array, array_length, &min_array_element, &max_array_element);
+
+	size_t counter_size = sizeof(uint64_t);
+	if (array_length <= UINT16_MAX) {
+		counter_size = sizeof(uint16_t);
+	} else if (array_length <= UINT32_MAX) {
+		counter_size = sizeof(uint32_t);
+	}
+
+	// In unsigned arithmetic, as the range of the whole int64_t domain does
+	// not fit in an int64_t, and compared before adding 1 so that it cannot
+	// wrap to 0
+	uint64_t element_range = (uint64_t)max_array_element - (uint64_t)min_array_element;
+	size_t memory_cap = sorts_counting_memory_cap();
+	if ((memory_cap != 0 && element_range >= memory_cap / counter_size) || element_range >= SIZE_MAX / counter_size) {
+		radixsort(array, array_length);
+		return;
+	}
+
+	size_t element_count = (size_t)element_range + 1;
+
+	void* counts_array = malloc(element_count * counter_size);
+	int64_t* results_array = malloc(array_length * sizeof(int64_t));
+	assert(counts_array != NULL && results_array != NULL);
+	sortstats_record_allocations(2);
+	sortstats_record_bytes(element_count * counter_size + array_length * sizeof(int64_t));
+
+	switch (counter_size) {
+	case sizeof(uint16_t):
+		countingsort_with_buffers_16(array, array_length, min_array_element, element_count, counts_array, results_array); break;
+	case sizeof(uint32_t):
+		countingsort_with_buffers_32(array, array_length, min_array_element, element_count, counts_array, results_array); break;
+	default:
+		countingsort_with_buffers(array, array_length, min_array_element, element_count, counts_array, results_array); break;
+	}
+
+	free(counts_array);
+	free(results_array);
+}
+
+// With many equal keys consecutive increments of the same counter wait for
+// each other through the store buffer. Counting the elements round robin in
+// COUNTINGSORT_HISTOGRAMS histograms breaks the chain; the histograms are
+// then laid out one after the other inside the range of every key, which is
+// fine since equal int64_t keys are indistinguishable. Large key ranges, whose
+// counters rarely repeat anyway, keep the single histogram.
+void countingsort_multi(int64_t* array, size_t array_length) {
+	if (array_length < 2) {
+		return;
+	}
+
+	int64_t max_array_element;
+	int64_t min_array_element;
+	scan_min_max(array, array_length, &min_array_element, &max_array_element);
+
+	// Unsigned and compared before adding 1, as for countingsort_adaptive, but
+	// without its memory cap
+	uint64_t element_range = (uint64_t)max_array_element - (uint64_t)min_array_element;
+	if (element_range >= SIZE_MAX / sizeof(uint64_t)) {
+		radixsort(array, array_length);
+		return;
+	}
+
+	size_t element_count = (size_t)element_range + 1;
+	if (element_count > COUNTINGSORT_MULTI_MAX_HISTOGRAMS_SIZE / (COUNTINGSORT_HISTOGRAMS * sizeof(uint64_t))) {
+		uint64_t* counts_array = malloc(element_count * sizeof(uint64_t));
+		int64_t* results_array = malloc(array_length * sizeof(int64_t));
+		assert(counts_array != NULL && results_array != NULL);
+		sortstats_record_allocations(2);
+		sortstats_record_bytes(element_count * sizeof(uint64_t) + array_length * sizeof(int64_t));
+
+		countingsort_with_buffers(array, array_length, min_array_element, element_count, counts_array, results_array);
+
+		free(counts_array);
+		free(results_array);
+		return;
+	}
+
+	uint64_t* counts_array = calloc(COUNTINGSORT_HISTOGRAMS * element_count, sizeof(uint64_t));
+	int64_t* results_array = malloc(array_length * sizeof(int64_t));
+	assert(counts_array != NULL && results_array != NULL);
+	sortstats_record_allocations(2);
+	sortstats_record_bytes(COUNTINGSORT_HISTOGRAMS * element_count * sizeof(uint64_t) + array_length * sizeof(int64_t));
+
+	uint64_t* counts[COUNTINGSORT_HISTOGRAMS];
+	for (size_t h = 0; h < COUNTINGSORT_HISTOGRAMS; h += 1) {
+		counts[h] = counts_array + h * element_count;
+	}
+
+	size_t unrolled_length = array_length - array_length % COUNTINGSORT_HISTOGRAMS;
+	for (size_t i = 0; i < unrolled_length; i += COUNTINGSORT_HISTOGRAMS) {
+		for (size_t h = 0; h < COUNTINGSORT_HISTOGRAMS; h += 1) {
+			counts[h][array[i + h] - min_array_element] += 1;
+		}
+	}
+	for (size_t i = unrolled_length; i < array_length; i += 1) {
+		counts[i % COUNTINGSORT_HISTOGRAMS][array[i] - min_array_element] += 1;
+	}
+
+	// Every histogram ends up holding the end of its part of the range of
+	// every key
+	uint64_t total = 0;
+	for (size_t key = 0; key < element_count; key += 1) {
+		for (size_t h = 0; h < COUNTINGSORT_HISTOGRAMS; h += 1) {
+			total += counts[h][key];
+			counts[h][key] = total;
+		}
+	}
+
+	for (size_t i = array_length; i > unrolled_length; i -= 1) {
+		int64_t key = array[i - 1] - min_array_element;
+		uint64_t* histogram = counts[(i - 1) % COUNTINGSORT_HISTOGRAMS];
+		histogram[key] -= 1;
+		results_array[histogram[key]] = array[i - 1];
+	}
+	for (size_t i = unrolled_length; i > 0; i -= COUNTINGSORT_HISTOGRAMS) {
+		for (size_t h = COUNTINGSORT_HISTOGRAMS; h > 0; h -= 1) {
+			int64_t key = array[i - COUNTINGSORT_HISTOGRAMS + h - 1] - min_array_element;
+			counts[h - 1][key] -= 1;
+			results_array[counts[h - 1][key]] = array[i - COUNTINGSORT_HISTOGRAMS + h - 1];
+		}
+	}
+
+	memcpy(array, results_array, array_length * sizeof(int64_t));
+
+	free(counts_array);
+	free(results_array);
+}
+
+typedef struct Countingsort_Parallel_Context Countingsort_Parallel_Context;
+typedef void (*Countingsort_Parallel_Phase)(Countingsort_Parallel_Context* context, size_t index);
+
+// Shared by the tasks of countingsort_parallel. Both the array and the key
+// range are split in chunk_count pieces, one per task.
+struct Countingsort_Parallel_Context {
+	int64_t* array;
+	size_t array_length;
+	size_t chunk_count;
+	Countingsort_Parallel_Phase phase;
+
+	// chunk_count minimums, maximums and key range totals
+	int64_t* chunk_min;
+	int64_t* chunk_max;
+	uint64_t* key_range_totals;
+
+	int64_t min_array_element;
+	size_t element_count;
+	// chunk_count histograms of element_count counters
+	uint64_t* counts;
+	int64_t* results_array;
+};
+
+static void countingsort_parallel_range(size_t length, size_t count, size_t index, size_t* start, size_t* end) {
+	*start = length / count * index + (index < length % count ? index : length % count);
+	*end = *start + length / count + (index < length % count ? 1 : 0);
+}
+
+static void countingsort_parallel_min_max(Countingsort_Parallel_Context* context, size_t index) {
+	size_t start, end;
+	countingsort_parallel_range(context->array_length, context->chunk_count, index, &start, &end);
+
+	scan_min_max(&context->array[start], end - start, &context->chunk_min[index], &context->chunk_max[index]);
+}
+
+static void countingsort_parallel_count(Countingsort_Parallel_Context* context, size_t index) {
+	size_t start, end;
+	countingsort_parallel_range(context->array_length, context->chunk_count, index, &start, &end);
+
+	uint64_t* counts = &context->counts[index * context->element_count];
+	memset(counts, 0, context->element_count * sizeof(uint64_t));
+	for (size_t i = start; i < end; i += 1) {
+		counts[context->array[i] - context->min_array_element] += 1;
+	}
+}
+
+static void countingsort_parallel_sum_keys(Countingsort_Parallel_Context* context, size_t index) {
+	size_t start, end;
+	countingsort_parallel_range(context->element_count, context->chunk_count, index, &start, &end);
+
+	uint64_t total = 0;
+	for (size_t chunk = 0; chunk < context->chunk_count; chunk += 1) {
+		const uint64_t* counts = &context->counts[chunk * context->element_count];
+		for (size_t key = start; key < end; key += 1) {
+			total += counts[key];
+		}
+	}
+
+	context->key_range_totals[index] = total;
+}
+
+// Turns the counters of the key range into the end of the range of every
+// chunk, chunks of the same key being laid out in order so that the sort
+// stays stable
+static void countingsort_parallel_prefix_keys(Countingsort_Parallel_Context* context, size_t index) {
+	size_t start, end;
+	countingsort_parallel_range(context->element_count, context->chunk_count, index, &start, &end);
+
+	uint64_t total = context->key_range_totals[index];
+	for (size_t key = start; key < end; key += 1) {
+		for (size_t chunk = 0; chunk < context->chunk_count; chunk += 1) {
+			uint64_t* counter = &context->counts[chunk * context->element_count + key];
+			total += *counter;
+			*counter = total;
+		}
+	}
+}
+
+static void countingsort_parallel_scatter(Countingsort_Parallel_Context* context, size_t index) {
+	size_t start, end;
+	countingsort_parallel_range(context->array_length, context->chunk_count, index, &start, &end);
+
+	uint64_t* counts = &context->counts[index * context->element_count];
+	for (size_t i = end; i > start; i -= 1) {
+		int64_t key = context->array[i - 1] - context->min_array_element;
+		counts[key] -= 1;
+		context->results_array[counts[key]] = context->array[i - 1];
+	}
+}
+
+static void countingsort_parallel_copy_back(Countingsort_Parallel_Context* context, size_t index) {
+	size_t start, end;
+	countingsort_parallel_range(context->array_length, context->chunk_count, index, &start, &end);
+
+	memcpy(&context->array[start], &context->results_array[start], (end - start) * sizeof(int64_t));
+}
+
+static void countingsort_parallel_task(Task_Pool* pool, size_t worker_index, Task task) {
+	(void)pool;
+	(void)worker_index;
+
+	Countingsort_Parallel_Context* context = task.user_data;
+	context->phase(context, task.index);
+}
+
+static void countingsort_parallel_root(Task_Pool* pool, size_t worker_index, Task task) {
+	Countingsort_Parallel_Context* context = task.user_data;
+
+	for (size_t i = 1; i < context->chunk_count; i += 1) {
+		Task spawned = task;
+		spawned.function = countingsort_parallel_task;
+		spawned.index = i;
+
+		taskpool_spawn(pool, worker_index, spawned);
+	}
+
+	context->phase(context, 0);
+}
+
+static void countingsort_parallel_run(Task_Pool* pool, Countingsort_Parallel_Context* context, Countingsort_Parallel_Phase phase) {
+	context->phase = phase;
+
+	// A single chunk is counted by the caller, without waking the pool
+	if (context->chunk_count == 1) {
+		phase(context, 0);
+		return;
+	}
+
+	Task root;
+	root.function = countingsort_parallel_root;
+	root.array = context->array;
+	root.array_length = context->array_length;
+	root.depth = 0;
+	root.index = 0;
+	root.user_data = context;
+
+	taskpool_run(pool, root);
+}
+
+void countingsort_parallel(int64_t* array, size_t array_length) {
+	size_t chunk_count = sorts_thread_count();
+	if (chunk_count > array_length / COUNTINGSORT_PARALLEL_MIN_CHUNK_LENGTH) {
+		chunk_count = array_length / COUNTINGSORT_PARALLEL_MIN_CHUNK_LENGTH;
+	}
+	if (chunk_count < 1) {
+		chunk_count = 1;
+	}
+
+	Task_Pool* pool = sorts_task_pool();
+
+	Countingsort_Parallel_Context context;
+	context.array = array;
+	context.array_length = array_length;
+	context.chunk_count = chunk_count;
+
+	int64_t* chunk_bounds = malloc(chunk_count * (2 * sizeof(int64_t) + sizeof(uint64_t)));
+	assert(chunk_bounds != NULL);
+	context.chunk_min = chunk_bounds;
+	context.chunk_max = chunk_bounds + chunk_count;
+	context.key_range_totals = (uint64_t*)(chunk_bounds + 2 * chunk_count);
+
+	countingsort_parallel_run(pool, &context, countingsort_parallel_min_max);
+
+	int64_t min_array_element = context.chunk_min[0];
+	int64_t max_array_element = context.chunk_max[0];
+	for (size_t i = 1; i < chunk_count; i += 1) {
+		if (context.chunk_min[i] < min_array_element) {
+			min_array_element = context.chunk_min[i];
+		}
+		if (context.chunk_max[i] > max_array_element) {
+			max_array_element = context.chunk_max[i];
+		}
+	}
+
+	// The cap bounds the histogram of every chunk, as a total one would make
+	// the thread count axis fall back to radixsort from 2 threads on
+	uint64_t element_range = (uint64_t)max_array_element - (uint64_t)min_array_element;
+	size_t memory_cap = sorts_counting_memory_cap();
+	if ((memory_cap != 0 && element_range >= memory_cap / sizeof(uint64_t)) || element_range >= SIZE_MAX / (chunk_count * sizeof(uint64_t))) {
+		free(chunk_bounds);
+		sortstats_record_allocations(1);
+		sortstats_record_bytes(chunk_count * (2 * sizeof(int64_t) + sizeof(uint64_t)));
+
+		radixsort(array, array_length);
+		return;
+	}
+
+	context.min_array_element = min_array_element;
+	context.element_count = (size_t)element_range + 1;
+	context.counts = malloc(chunk_count * context.element_count * sizeof(uint64_t));
+	context.results_array = malloc(array_length * sizeof(int64_t));
+	assert(context.counts != NULL && context.results_array != NULL);
+	sortstats_record_allocations(3);
+	sortstats_record_bytes(
+		chunk_count * (2 * sizeof(int64_t) + sizeof(uint64_t))
+		+ chunk_count * context.element_count * sizeof(uint64_t)
+		+ array_length * sizeof(int64_t)
+	);
+
+	countingsort_parallel_run(pool, &context, countingsort_parallel_count);
+	countingsort_parallel_run(pool, &context, countingsort_parallel_sum_keys);
+
+	// Exclusive scan of the few key range totals
+	uint64_t total = 0;
+	for (size_t i = 0; i < chunk_count; i += 1) {
+		uint64_t key_range_total = context.key_range_totals[i];
+		context.key_range_totals[i] = total;
+		total += key_range_total;
+	}
+
+	countingsort_parallel_run(pool, &context, countingsort_parallel_prefix_keys);
+	countingsort_parallel_run(pool, &context, countingsort_parallel_scatter);
+	countingsort_parallel_run(pool, &context, countingsort_parallel_copy_back);
+
+	free(chunk_bounds);
+	free(context.counts);
+	free(context.results_array);
+}
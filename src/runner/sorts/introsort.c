@@ -0,0 +1,549 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "sorts/sorts.h"
+#include "sorts/task_pool.h"
+#include "sorts/partition.h"
+#include "sorts/stats.h"
+
+// Partitions shorter than this are sorted serially by the task that owns them,
+// as spawning them would cost more than it saves
+#define INTROSORT_PARALLEL_CUTOFF 16384
+
+// Partitions of at most this many elements are insertion sorted by
+// introsort_pdq
+#define PDQSORT_INSERTION_CUTOFF 24
+// Elements the partial insertion sort may move before giving up on a
+// partition that looked sorted
+#define PDQSORT_PARTIAL_INSERTION_LIMIT 8
+// A partition with a side shorter than 1/PDQSORT_UNBALANCED_FRACTION of it is
+// a bad one
+#define PDQSORT_UNBALANCED_FRACTION 8
+// Arrays made of a sorted run followed by at most 1/PDQSORT_TAIL_FRACTION of
+// other elements only sort those and merge them into the run
+#define PDQSORT_TAIL_FRACTION 8
+
+typedef size_t (*Partition_Function)(int64_t arr[], size_t low, size_t high);
+
+typedef struct {
+	Partition_Function partition_function;
+	Pivot_Strategy pivot_strategy;
+	uint64_t random_state;
+	Small_Sort_Leaf leaf;
+
+	size_t depth;
+	size_t peak_depth;
+} Introsort_Context;
+
+typedef struct {
+	int64_t* heap;
+	size_t heap_size;
+	size_t element_count;
+} Max_Heap;
+
+static void swap(int64_t* a, int64_t* b) {
+	int64_t t = *a;
+	*a = *b;
+	*b = t;
+}
+
+static void maxheap_create(Max_Heap* heap, int64_t* backing_memory, size_t backing_memory_length) {
+	heap->heap = backing_memory;
+	heap->heap_size = backing_memory_length;
+	heap->element_count = 0;
+}
+
+static size_t maxheap_left_index(size_t i) {
+	return i * 2 + 1;
+}
+
+static size_t maxheap_right_index(size_t i) {
+	return i * 2 + 2;
+}
+
+static void maxheap_heapify(Max_Heap heap, size_t index) {
+	size_t swap_index = index;
+	size_t left = maxheap_left_index(index);
+	size_t right = maxheap_right_index(index);
+
+	if (left < heap.element_count && heap.heap[left] > heap.heap[swap_index]) {
+		swap_index = left;
+	}
+	if (right < heap.element_count && heap.heap[right] > heap.heap[swap_index]) {
+		swap_index = right;
+	}
+
+	if (swap_index == index) {
+		return;
+	}
+
+	swap(&heap.heap[index], &heap.heap[swap_index]);
+	maxheap_heapify(heap, swap_index);
+}
+
+static void maxheap_buildheap(Max_Heap* heap) {
+	heap->element_count = heap->heap_size;
+
+	size_t i = (heap->heap_size / 2);
+	while (i > 0) {
+		i -= 1;
+
+		maxheap_heapify(*heap, i);
+	}
+}
+
+static int64_t maxheap_remove_max(Max_Heap* heap) {
+	assert(heap->element_count > 0);
+
+	int64_t max = heap->heap[0];
+
+	swap(&heap->heap[0], &heap->heap[heap->element_count - 1]);
+	heap->element_count -= 1;
+
+	maxheap_heapify(*heap, 0);
+
+	return max;
+}
+
+static void heap_sort(int64_t* array, size_t array_length) {
+	Max_Heap heap;
+	maxheap_create(&heap, array, array_length);
+
+	maxheap_buildheap(&heap);
+
+	while (heap.element_count > 0) {
+		maxheap_remove_max(&heap);
+	}
+}
+
+static void insertion_sort(int64_t* array, size_t array_length) {
+	for (size_t i = 1; i < array_length; i++) {
+		int64_t key = array[i];
+		ssize_t j = (ssize_t)i - 1;
+
+		while (j >= 0) {
+			if (array[j] > key) {
+				array[j + 1] = array[j];
+				j--;
+			} else {
+				break;
+			}
+		}
+		array[j + 1] = key;
+	}
+}
+
+static size_t partition(int64_t arr[], size_t low, size_t high) {
+	int64_t pivot = arr[high];
+	int64_t i = low - 1;
+	for (int64_t j = low; j <= high - 1; j++) {
+		if (arr[j] < pivot) {
+			i++;
+			swap(&arr[i], &arr[j]);
+		}
+	}
+	swap(&arr[i + 1], &arr[high]);
+	return i + 1;
+}
+
+static size_t partition_block(int64_t arr[], size_t low, size_t high) {
+	return low + block_partition(arr + low, high - low + 1);
+}
+
+static void introsort_context_create(Introsort_Context* context, Partition_Function partition_function, uint64_t random_seed) {
+	context->partition_function = partition_function;
+	context->pivot_strategy = sorts_pivot_strategy();
+	context->random_state = random_seed;
+	// Partitions shorter than 16 elements are insertion sorted by default
+	context->leaf = sorts_small_sort_leaf(15);
+	context->depth = 0;
+	context->peak_depth = 0;
+}
+
+static size_t introsort_partition(int64_t array[], size_t low, size_t high, Introsort_Context* context) {
+	// Both partitions use the last element as pivot
+	size_t pivot_index = pivot_select(array, low, high, high, context->pivot_strategy, &context->random_state);
+	swap(&array[pivot_index], &array[high]);
+
+	return context->partition_function(array, low, high);
+}
+
+static void introsort_helper(int64_t array[], size_t low, size_t high, size_t max_depth, Introsort_Context* context) {
+	size_t section_length = high - low + 1;
+
+	context->depth += 1;
+	if (context->depth > context->peak_depth) {
+		context->peak_depth = context->depth;
+	}
+
+	if (section_length <= 0) {
+		// Nothing to sort
+	} else if (section_length <= context->leaf.cutoff) {
+		if (context->leaf.function != NULL) {
+			context->leaf.function(array + low, section_length);
+		} else {
+			insertion_sort(array + low, section_length);
+		}
+	} else if (max_depth == 0) {
+		heap_sort(array + low, section_length);
+	} else {
+		size_t p = introsort_partition(array, low, high, context);
+
+		introsort_helper(array, low, p - 1, max_depth - 1, context);
+		introsort_helper(array, p + 1, high, max_depth - 1, context);
+	}
+
+	context->depth -= 1;
+}
+
+void introsort(int64_t* array, size_t array_length) {
+	if (array_length <= 0) {
+		return;
+	}
+
+	Introsort_Context context;
+	introsort_context_create(&context, partition, PIVOT_RANDOM_SEED);
+
+	size_t max_depth = (size_t)log2(array_length) * 2;
+	introsort_helper(array, 0, array_length - 1, max_depth, &context);
+
+	sortstats_record_recursion_depth(context.peak_depth);
+}
+
+void introsort_block(int64_t* array, size_t array_length) {
+	if (array_length <= 0) {
+		return;
+	}
+
+	Introsort_Context context;
+	introsort_context_create(&context, partition_block, PIVOT_RANDOM_SEED);
+
+	size_t max_depth = (size_t)log2(array_length) * 2;
+	introsort_helper(array, 0, array_length - 1, max_depth, &context);
+
+	sortstats_record_recursion_depth(context.peak_depth);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// PATTERN DEFEATING INTROSORT
+////////////////////////////////////////////////////////////////////////////////
+
+// Introsort after Orson Peters' pdqsort: it partitions around a pivot that is
+// left at array[0], notices the partitions that needed no swap and finishes
+// them with a bounded insertion sort, and breaks up the patterns that cause
+// unbalanced partitions by swapping a few elements before falling back to
+// heap_sort.
+
+static void reverse(int64_t* array, size_t array_length) {
+	for (size_t i = 0; i < array_length / 2; i += 1) {
+		swap(&array[i], &array[array_length - 1 - i]);
+	}
+}
+
+// Insertion sort that gives up after moving PDQSORT_PARTIAL_INSERTION_LIMIT
+// elements, returning whether the array got sorted
+static bool partial_insertion_sort(int64_t* array, size_t array_length) {
+	size_t moved = 0;
+
+	for (size_t i = 1; i < array_length; i += 1) {
+		if (moved > PDQSORT_PARTIAL_INSERTION_LIMIT) {
+			return false;
+		}
+
+		int64_t key = array[i];
+		size_t j = i;
+		while (j > 0 && array[j - 1] > key) {
+			array[j] = array[j - 1];
+			j -= 1;
+		}
+		array[j] = key;
+		moved += i - j;
+	}
+
+	return true;
+}
+
+// Partitions around array[0]: the smaller elements end up before it, the
+// others after. Returns the final index of the pivot, with already_partitioned
+// telling whether no element had to be swapped.
+static size_t pdq_partition_right(int64_t* array, size_t array_length, bool* already_partitioned) {
+	int64_t pivot = array[0];
+
+	size_t first = 1;
+	while (first < array_length && array[first] < pivot) {
+		first += 1;
+	}
+	size_t last = array_length;
+	while (last > first && !(array[last - 1] < pivot)) {
+		last -= 1;
+	}
+
+	*already_partitioned = first >= last;
+
+	// array[first] is not smaller than the pivot and array[last - 1] is
+	while (first < last) {
+		swap(&array[first], &array[last - 1]);
+		first += 1;
+		last -= 1;
+
+		while (first < last && array[first] < pivot) {
+			first += 1;
+		}
+		while (first < last && !(array[last - 1] < pivot)) {
+			last -= 1;
+		}
+	}
+
+	size_t pivot_index = first - 1;
+	swap(&array[0], &array[pivot_index]);
+	return pivot_index;
+}
+
+// Same as pdq_partition_right, but with the elements equal to the pivot
+// before it
+static size_t pdq_partition_left(int64_t* array, size_t array_length) {
+	int64_t pivot = array[0];
+
+	size_t last = array_length;
+	while (last > 1 && pivot < array[last - 1]) {
+		last -= 1;
+	}
+	size_t first = 1;
+	while (first < last && !(pivot < array[first])) {
+		first += 1;
+	}
+
+	while (first < last) {
+		swap(&array[first], &array[last - 1]);
+		first += 1;
+		last -= 1;
+
+		while (first < last && !(pivot < array[first])) {
+			first += 1;
+		}
+		while (first < last && pivot < array[last - 1]) {
+			last -= 1;
+		}
+	}
+
+	size_t pivot_index = last - 1;
+	swap(&array[0], &array[pivot_index]);
+	return pivot_index;
+}
+
+// Swaps a few elements of a side of a bad partition, at a quarter of its
+// length from both ends
+static void pdq_break_patterns(int64_t* array, size_t array_length) {
+	if (array_length < PDQSORT_INSERTION_CUTOFF) {
+		return;
+	}
+
+	size_t quarter = array_length / 4;
+	swap(&array[0], &array[quarter]);
+	swap(&array[array_length - 1], &array[array_length - 1 - quarter]);
+
+	if (array_length > PIVOT_NINTHER_THRESHOLD) {
+		swap(&array[1], &array[quarter + 1]);
+		swap(&array[2], &array[quarter + 2]);
+		swap(&array[array_length - 2], &array[array_length - 2 - quarter]);
+		swap(&array[array_length - 3], &array[array_length - 3 - quarter]);
+	}
+}
+
+// leftmost tells whether array is at the start of the sorted array: the other
+// partitions have array[-1], a previous pivot, which is at most any of their
+// elements
+static void pdq_helper(int64_t* array, size_t array_length, size_t bad_partitions_allowed, bool leftmost, Introsort_Context* context) {
+	context->depth += 1;
+	if (context->depth > context->peak_depth) {
+		context->peak_depth = context->depth;
+	}
+
+	while (true) {
+		if (array_length <= context->leaf.cutoff) {
+			if (context->leaf.function != NULL) {
+				context->leaf.function(array, array_length);
+			} else {
+				insertion_sort(array, array_length);
+			}
+			break;
+		}
+
+		size_t pivot_index = pivot_select(array, 0, array_length - 1, array_length / 2, context->pivot_strategy, &context->random_state);
+		swap(&array[0], &array[pivot_index]);
+
+		// A pivot equal to the previous one is the smallest element of the
+		// partition, so the elements equal to it are already in place
+		if (!leftmost && !(array[-1] < array[0])) {
+			size_t p = pdq_partition_left(array, array_length);
+			array += p + 1;
+			array_length -= p + 1;
+			continue;
+		}
+
+		bool already_partitioned;
+		size_t p = pdq_partition_right(array, array_length, &already_partitioned);
+		size_t left_length = p;
+		size_t right_length = array_length - p - 1;
+
+		if (left_length < array_length / PDQSORT_UNBALANCED_FRACTION || right_length < array_length / PDQSORT_UNBALANCED_FRACTION) {
+			bad_partitions_allowed -= 1;
+			if (bad_partitions_allowed == 0) {
+				heap_sort(array, array_length);
+				break;
+			}
+
+			pdq_break_patterns(array, left_length);
+			pdq_break_patterns(array + p + 1, right_length);
+		} else if (already_partitioned) {
+			// Probably a sorted run, which a few moves finish
+			if (partial_insertion_sort(array, left_length) && partial_insertion_sort(array + p + 1, right_length)) {
+				break;
+			}
+		}
+
+		pdq_helper(array, left_length, bad_partitions_allowed, leftmost, context);
+		array += p + 1;
+		array_length = right_length;
+		leftmost = false;
+	}
+
+	context->depth -= 1;
+}
+
+// Merges the sorted array[0..run_length - 1] and the sorted rest of the array,
+// which is copied to the scratch arena
+static void merge_tail(int64_t* array, size_t run_length, size_t array_length, Scratch_Arena* scratch) {
+	size_t tail_length = array_length - run_length;
+	int64_t* tail = scratcharena_alloc(scratch, tail_length * sizeof(int64_t));
+	memcpy(tail, array + run_length, tail_length * sizeof(int64_t));
+
+	// Merging from the end, the run only moves towards free slots
+	size_t i = run_length;
+	size_t j = tail_length;
+	size_t k = array_length;
+	while (j > 0) {
+		k -= 1;
+		if (i > 0 && array[i - 1] > tail[j - 1]) {
+			array[k] = array[i - 1];
+			i -= 1;
+		} else {
+			array[k] = tail[j - 1];
+			j -= 1;
+		}
+	}
+
+	scratcharena_reset(scratch);
+}
+
+void introsort_pdq(int64_t* array, size_t array_length) {
+	if (array_length < 2) {
+		return;
+	}
+
+	Introsort_Context context;
+	// The partition is pdq_partition_right, not a Partition_Function
+	introsort_context_create(&context, NULL, PIVOT_RANDOM_SEED);
+	context.leaf = sorts_small_sort_leaf(PDQSORT_INSERTION_CUTOFF);
+	// The last element would be a bad default pivot on the sorted inputs this
+	// kernel is meant for
+	if (context.pivot_strategy == PIVOTSTRATEGY_DEFAULT) {
+		context.pivot_strategy = PIVOTSTRATEGY_NINTHER;
+	}
+
+	// Leading run, ascending or strictly descending
+	size_t run_length = 2;
+	if (array[1] < array[0]) {
+		while (run_length < array_length && array[run_length] < array[run_length - 1]) {
+			run_length += 1;
+		}
+		reverse(array, run_length);
+	} else {
+		while (run_length < array_length && array[run_length] >= array[run_length - 1]) {
+			run_length += 1;
+		}
+	}
+
+	// Bad partitions tolerated before falling back to heap_sort, as in pdqsort
+	size_t bad_partitions_allowed = (size_t)log2(array_length);
+	if (run_length == array_length) {
+		// Nothing else to sort
+	} else if (array_length - run_length <= array_length / PDQSORT_TAIL_FRACTION) {
+		pdq_helper(array + run_length, array_length - run_length, bad_partitions_allowed, true, &context);
+		merge_tail(array, run_length, array_length, sorts_thread_scratch());
+	} else {
+		pdq_helper(array, array_length, bad_partitions_allowed, true, &context);
+	}
+
+	sortstats_record_recursion_depth(context.peak_depth);
+}
+
+static void introsort_parallel_task(Task_Pool* pool, size_t worker_index, Task task) {
+	int64_t* array = task.array;
+	size_t array_length = task.array_length;
+	size_t max_depth = task.depth;
+
+	// Every task owns its random state, seeded from its own length so that
+	// sibling tasks do not pick pivots in lockstep
+	Introsort_Context context;
+	introsort_context_create(&context, partition, PIVOT_RANDOM_SEED ^ (uint64_t)array_length);
+
+	while (array_length >= INTROSORT_PARALLEL_CUTOFF && max_depth > 0) {
+		size_t p = introsort_partition(array, 0, array_length - 1, &context);
+		max_depth -= 1;
+
+		size_t left_length = p;
+		size_t right_length = array_length - p - 1;
+
+		// The larger side is offered to the other workers, the smaller one is
+		// kept, so that thieves get the biggest chunks of work
+		Task spawned = task;
+		if (left_length > right_length) {
+			spawned.array = array;
+			spawned.array_length = left_length;
+			array = array + p + 1;
+			array_length = right_length;
+		} else {
+			spawned.array = array + p + 1;
+			spawned.array_length = right_length;
+			array_length = left_length;
+		}
+		spawned.depth = max_depth;
+
+		taskpool_spawn(pool, worker_index, spawned);
+	}
+
+	if (array_length > 0) {
+		introsort_helper(array, 0, array_length - 1, max_depth, &context);
+	}
+}
+
+void introsort_parallel(int64_t* array, size_t array_length) {
+	if (array_length <= 0) {
+		return;
+	}
+
+	size_t max_depth = (size_t)log2(array_length) * 2;
+	if (array_length < INTROSORT_PARALLEL_CUTOFF) {
+		Introsort_Context context;
+		introsort_context_create(&context, partition, PIVOT_RANDOM_SEED);
+
+		introsort_helper(array, 0, array_length - 1, max_depth, &context);
+		return;
+	}
+
+	Task root;
+	root.function = introsort_parallel_task;
+	root.array = array;
+	root.array_length = array_length;
+	root.depth = max_depth;
+	root.index = 0;
+	root.user_data = NULL;
+
+	taskpool_run(sorts_task_pool(), root);
+}
@@ -0,0 +1,87 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "sorts/loser_tree.h"
+
+void losertree_create(Loser_Tree* tree, size_t run_count) {
+	assert(run_count > 0);
+
+	size_t leaf_count = 1;
+	while (leaf_count < run_count) {
+		leaf_count *= 2;
+	}
+
+	// heads, ends and nodes in one allocation
+	void* memory = malloc(leaf_count * (2 * sizeof(int64_t*) + sizeof(size_t)));
+	assert(memory != NULL);
+
+	tree->heads = memory;
+	tree->ends = tree->heads + leaf_count;
+	tree->nodes = (size_t*)(tree->ends + leaf_count);
+	tree->leaf_count = leaf_count;
+	tree->run_count = run_count;
+	tree->winner = 0;
+
+	for (size_t run = 0; run < leaf_count; run += 1) {
+		tree->heads[run] = NULL;
+		tree->ends[run] = NULL;
+	}
+}
+
+void losertree_destroy(Loser_Tree* tree) {
+	free(tree->heads);
+}
+
+// An exhausted run loses every match
+static bool losertree_beats(const Loser_Tree* tree, size_t a, size_t b) {
+	if (tree->heads[a] == tree->ends[a]) {
+		return false;
+	}
+	if (tree->heads[b] == tree->ends[b]) {
+		return true;
+	}
+
+	return *tree->heads[a] <= *tree->heads[b];
+}
+
+// Plays the matches of the subtree of node, returning its winner. The leaves
+// are the nodes from leaf_count on.
+static size_t losertree_build_node(Loser_Tree* tree, size_t node) {
+	if (node >= tree->leaf_count) {
+		return node - tree->leaf_count;
+	}
+
+	size_t left = losertree_build_node(tree, 2 * node);
+	size_t right = losertree_build_node(tree, 2 * node + 1);
+	if (losertree_beats(tree, left, right)) {
+		tree->nodes[node] = right;
+		return left;
+	}
+
+	tree->nodes[node] = left;
+	return right;
+}
+
+void losertree_build(Loser_Tree* tree) {
+	tree->winner = losertree_build_node(tree, 1);
+}
+
+void losertree_replay(Loser_Tree* tree, size_t run) {
+	size_t winner = run;
+	for (size_t node = (run + tree->leaf_count) / 2; node > 0; node /= 2) {
+		if (losertree_beats(tree, tree->nodes[node], winner)) {
+			size_t loser = winner;
+			winner = tree->nodes[node];
+			tree->nodes[node] = loser;
+		}
+	}
+
+	tree->winner = winner;
+}
+
+bool losertree_empty(const Loser_Tree* tree) {
+	return tree->heads[tree->winner] == tree->ends[tree->winner];
+}
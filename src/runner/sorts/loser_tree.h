@@ -0,0 +1,42 @@
+#ifndef SORTS_LOSER_TREE_H
+#define SORTS_LOSER_TREE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// LOSER TREE
+////////////////////////////////////////////////////////////////////////////////
+
+// Tournament tree of the losers, merging sorted runs: every internal node
+// keeps the run that lost the match played there, so that replacing the
+// winner only replays the matches on its path to the root.
+typedef struct {
+	// Next and past the last element of every run in memory, set by the
+	// caller. An exhausted run (head == end) loses every match.
+	const int64_t** heads;
+	const int64_t** ends;
+	size_t* nodes;
+	// A power of two, the runs past run_count are always empty
+	size_t leaf_count;
+	size_t run_count;
+	// Run holding the smallest head, valid after losertree_build
+	size_t winner;
+} Loser_Tree;
+
+// The heads and ends of the runs start empty
+void losertree_create(Loser_Tree* tree, size_t run_count);
+void losertree_destroy(Loser_Tree* tree);
+
+// Plays every match, once the heads and ends of the runs are set
+void losertree_build(Loser_Tree* tree);
+// Replays the matches of the given run after its head or end changed, which
+// must be the winner
+void losertree_replay(Loser_Tree* tree, size_t run);
+
+// True once every run is exhausted
+bool losertree_empty(const Loser_Tree* tree);
+
+#endif
@@ -0,0 +1,230 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "sorts/sorts.h"
+#include "sorts/task_pool.h"
+#include "sorts/loser_tree.h"
+#include "sorts/stats.h"
+
+// Below this many elements per thread the array is sorted by one thread
+#define MERGESORT_MIN_CHUNK_LENGTH 65536
+
+typedef struct Mergesort_Context Mergesort_Context;
+typedef void (*Mergesort_Phase)(Mergesort_Context* context, size_t index);
+
+struct Mergesort_Context {
+	int64_t* array;
+	size_t array_length;
+	// The array is split in chunk_count runs, sorted independently, then the
+	// output is split in chunk_count parts, each merged from all the runs
+	size_t chunk_count;
+	Mergesort_Phase phase;
+
+	// (chunk_count + 1) * chunk_count: splits[part * chunk_count + run] is
+	// where the elements of the given output part start in the given run
+	size_t* splits;
+	int64_t* buffer;
+};
+
+static size_t mergesort_chunk_start(const Mergesort_Context* context, size_t index) {
+	return context->array_length * index / context->chunk_count;
+}
+
+// Number of elements of the sorted array[0..array_length - 1] smaller than
+// element, or at most element when inclusive
+static size_t count_below(const int64_t* array, size_t array_length, int64_t element, bool inclusive) {
+	size_t low = 0;
+	size_t high = array_length;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (array[middle] < element || (inclusive && array[middle] == element)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+static void mergesort_sort_run(Mergesort_Context* context, size_t index) {
+	size_t start = mergesort_chunk_start(context, index);
+	size_t end = mergesort_chunk_start(context, index + 1);
+
+	introsort_pdq(context->array + start, end - start);
+}
+
+// Multisequence selection: finds where the first rank elements of the merged
+// runs end in every run. The element of the given rank is found by a binary
+// search over the values, then the runs give up their elements equal to it in
+// order, so that the splits of increasing ranks never go back.
+static void mergesort_split(Mergesort_Context* context, size_t index) {
+	size_t rank = mergesort_chunk_start(context, index);
+	size_t* splits = &context->splits[index * context->chunk_count];
+
+	int64_t minimum = INT64_MAX;
+	int64_t maximum = INT64_MIN;
+	for (size_t run = 0; run < context->chunk_count; run += 1) {
+		size_t start = mergesort_chunk_start(context, run);
+		size_t end = mergesort_chunk_start(context, run + 1);
+		if (context->array[start] < minimum) {
+			minimum = context->array[start];
+		}
+		if (context->array[end - 1] > maximum) {
+			maximum = context->array[end - 1];
+		}
+	}
+
+	// Smallest value with more than rank elements at most equal to it
+	uint64_t low = 0;
+	uint64_t high = (uint64_t)maximum - (uint64_t)minimum;
+	while (low < high) {
+		uint64_t middle = low + (high - low) / 2;
+		int64_t element = (int64_t)((uint64_t)minimum + middle);
+
+		size_t count = 0;
+		for (size_t run = 0; run < context->chunk_count; run += 1) {
+			size_t start = mergesort_chunk_start(context, run);
+			size_t end = mergesort_chunk_start(context, run + 1);
+			count += count_below(context->array + start, end - start, element, true);
+		}
+
+		if (count > rank) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+	int64_t element = (int64_t)((uint64_t)minimum + low);
+
+	size_t remaining = rank;
+	for (size_t run = 0; run < context->chunk_count; run += 1) {
+		size_t start = mergesort_chunk_start(context, run);
+		size_t end = mergesort_chunk_start(context, run + 1);
+		splits[run] = count_below(context->array + start, end - start, element, false);
+		remaining -= splits[run];
+	}
+	for (size_t run = 0; run < context->chunk_count; run += 1) {
+		size_t start = mergesort_chunk_start(context, run);
+		size_t end = mergesort_chunk_start(context, run + 1);
+		size_t equal = count_below(context->array + start, end - start, element, true) - splits[run];
+		if (equal > remaining) {
+			equal = remaining;
+		}
+
+		splits[run] += equal;
+		remaining -= equal;
+	}
+	assert(remaining == 0);
+}
+
+static void mergesort_merge_part(Mergesort_Context* context, size_t index) {
+	Loser_Tree tree;
+	losertree_create(&tree, context->chunk_count);
+
+	const size_t* splits = &context->splits[index * context->chunk_count];
+	const size_t* next_splits = &context->splits[(index + 1) * context->chunk_count];
+	for (size_t run = 0; run < context->chunk_count; run += 1) {
+		const int64_t* start = context->array + mergesort_chunk_start(context, run);
+		tree.heads[run] = start + splits[run];
+		tree.ends[run] = start + next_splits[run];
+	}
+	losertree_build(&tree);
+
+	size_t start = mergesort_chunk_start(context, index);
+	size_t end = mergesort_chunk_start(context, index + 1);
+	for (size_t i = start; i < end; i += 1) {
+		size_t winner = tree.winner;
+		context->buffer[i] = *tree.heads[winner];
+		tree.heads[winner] += 1;
+
+		losertree_replay(&tree, winner);
+	}
+
+	losertree_destroy(&tree);
+}
+
+static void mergesort_copy_back(Mergesort_Context* context, size_t index) {
+	size_t start = mergesort_chunk_start(context, index);
+	size_t end = mergesort_chunk_start(context, index + 1);
+
+	memcpy(&context->array[start], &context->buffer[start], (end - start) * sizeof(int64_t));
+}
+
+static void mergesort_task(Task_Pool* pool, size_t worker_index, Task task) {
+	(void)pool;
+	(void)worker_index;
+
+	Mergesort_Context* context = task.user_data;
+	context->phase(context, task.index);
+}
+
+static void mergesort_root(Task_Pool* pool, size_t worker_index, Task task) {
+	Mergesort_Context* context = task.user_data;
+
+	for (size_t i = 1; i < context->chunk_count; i += 1) {
+		Task spawned = task;
+		spawned.function = mergesort_task;
+		spawned.index = i;
+
+		taskpool_spawn(pool, worker_index, spawned);
+	}
+
+	context->phase(context, 0);
+}
+
+static void mergesort_run(Task_Pool* pool, Mergesort_Context* context, Mergesort_Phase phase) {
+	context->phase = phase;
+
+	Task root;
+	root.function = mergesort_root;
+	root.array = context->array;
+	root.array_length = context->array_length;
+	root.depth = 0;
+	root.index = 0;
+	root.user_data = context;
+
+	taskpool_run(pool, root);
+}
+
+void mergesort_parallel(int64_t* array, size_t array_length) {
+	size_t chunk_count = sorts_thread_count();
+	if (chunk_count > array_length / MERGESORT_MIN_CHUNK_LENGTH) {
+		chunk_count = array_length / MERGESORT_MIN_CHUNK_LENGTH;
+	}
+	if (chunk_count <= 1) {
+		introsort_pdq(array, array_length);
+		return;
+	}
+
+	Task_Pool* pool = sorts_task_pool();
+
+	Mergesort_Context context;
+	context.array = array;
+	context.array_length = array_length;
+	context.chunk_count = chunk_count;
+
+	context.splits = malloc((chunk_count + 1) * chunk_count * sizeof(size_t));
+	context.buffer = malloc(array_length * sizeof(int64_t));
+	assert(context.splits != NULL && context.buffer != NULL);
+	sortstats_record_allocations(2 + chunk_count);
+	sortstats_record_bytes((chunk_count + 1) * chunk_count * sizeof(size_t) + array_length * sizeof(int64_t));
+
+	mergesort_run(pool, &context, mergesort_sort_run);
+
+	// The part past the last one starts at the end of every run
+	for (size_t run = 0; run < chunk_count; run += 1) {
+		context.splits[chunk_count * chunk_count + run] = mergesort_chunk_start(&context, run + 1) - mergesort_chunk_start(&context, run);
+	}
+	mergesort_run(pool, &context, mergesort_split);
+
+	mergesort_run(pool, &context, mergesort_merge_part);
+	mergesort_run(pool, &context, mergesort_copy_back);
+
+	free(context.splits);
+	free(context.buffer);
+}
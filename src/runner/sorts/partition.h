@@ -0,0 +1,101 @@
+#ifndef SORTS_PARTITION_H
+#define SORTS_PARTITION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Elements classified per block. Offsets are stored in unsigned chars, so it
+// must not exceed 256.
+#define BLOCK_PARTITION_BLOCK_SIZE 64
+
+// BlockQuicksort partition (Edelkamp, Weiss). Partitions array around its last
+// element, with the same contract as the Lomuto partition: the returned index
+// holds the pivot, every element before it is smaller and every element after
+// it is greater or equal. The comparisons only produce offsets into small
+// buffers and never drive a branch, so random input does not cause branch
+// mispredictions.
+size_t block_partition(int64_t* array, size_t array_length);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PIVOT SELECTION
+////////////////////////////////////////////////////////////////////////////////
+
+// Arrays at least this long use the ninther instead of the median of 3
+#define PIVOT_NINTHER_THRESHOLD 128
+// Every sort starts from the same random state, so runs are reproducible
+#define PIVOT_RANDOM_SEED 0x9E3779B97F4A7C15ULL
+
+typedef enum {
+	// The original choice of every kernel: the last element for quicksort and
+	// introsort, the first one for quicksort3way
+	PIVOTSTRATEGY_DEFAULT,
+	// Median of the first, middle and last element
+	PIVOTSTRATEGY_MEDIAN_OF_3,
+	// Tukey's ninther: median of the medians of 3 evenly spaced triplets
+	PIVOTSTRATEGY_NINTHER,
+	// Uniformly random element
+	PIVOTSTRATEGY_RANDOM,
+
+	PIVOTSTRATEGY_COUNT,
+} Pivot_Strategy;
+
+const char* pivotstrategy_name(Pivot_Strategy strategy);
+bool pivotstrategy_parse(const char* name, Pivot_Strategy* strategy);
+
+// Strategy used by the kernels that support it. Read once at the start of
+// every sort, so it must not be changed while a kernel is running.
+void sorts_set_pivot_strategy(Pivot_Strategy strategy);
+Pivot_Strategy sorts_pivot_strategy(void);
+
+// Returns the index of the pivot chosen in array[low..high] (both included).
+// For PIVOTSTRATEGY_DEFAULT it returns default_index. random_state is only
+// used by PIVOTSTRATEGY_RANDOM and must not be zero.
+size_t pivot_select(int64_t* array, size_t low, size_t high, size_t default_index, Pivot_Strategy strategy, uint64_t* random_state);
+
+// xorshift64*, the generator of PIVOTSTRATEGY_RANDOM
+uint64_t pivot_next_random(uint64_t* random_state);
+
+// Defines a static function_name with the contract of pivot_select for arrays
+// of Type, which must be ordered by <
+#define PIVOT_DEFINE_SELECT(function_name, Type) \
+	static size_t function_name##_median_of_3(Type* array, size_t a, size_t b, size_t c) { \
+		if (array[a] < array[b]) { \
+			if (array[b] < array[c]) { \
+				return b; \
+			} \
+			return array[a] < array[c] ? c : a; \
+		} else { \
+			if (array[a] < array[c]) { \
+				return a; \
+			} \
+			return array[b] < array[c] ? c : b; \
+		} \
+	} \
+	\
+	static size_t function_name(Type* array, size_t low, size_t high, size_t default_index, Pivot_Strategy strategy, uint64_t* random_state) { \
+		size_t length = high - low + 1; \
+		size_t middle = low + length / 2; \
+		\
+		switch (strategy) { \
+		case PIVOTSTRATEGY_MEDIAN_OF_3: \
+			return function_name##_median_of_3(array, low, middle, high); \
+		case PIVOTSTRATEGY_NINTHER: \
+			if (length >= PIVOT_NINTHER_THRESHOLD) { \
+				size_t step = length / 8; \
+				return function_name##_median_of_3(array, \
+					function_name##_median_of_3(array, low, low + step, low + step * 2), \
+					function_name##_median_of_3(array, middle - step, middle, middle + step), \
+					function_name##_median_of_3(array, high - step * 2, high - step, high) \
+				); \
+			} \
+			return function_name##_median_of_3(array, low, middle, high); \
+		case PIVOTSTRATEGY_RANDOM: \
+			return low + (size_t)(pivot_next_random(random_state) % length); \
+		default: \
+			return default_index; \
+		} \
+	}
+
+#endif
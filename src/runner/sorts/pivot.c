@@ -0,0 +1,55 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sorts/partition.h"
+
+static const char* g_pivot_strategy_names[PIVOTSTRATEGY_COUNT] = {
+	"default",
+	"median3",
+	"ninther",
+	"random",
+};
+
+static Pivot_Strategy g_pivot_strategy = PIVOTSTRATEGY_DEFAULT;
+
+const char* pivotstrategy_name(Pivot_Strategy strategy) {
+	return g_pivot_strategy_names[strategy];
+}
+
+bool pivotstrategy_parse(const char* name, Pivot_Strategy* strategy) {
+	for (size_t i = 0; i < PIVOTSTRATEGY_COUNT; i += 1) {
+		if (strcmp(g_pivot_strategy_names[i], name) == 0) {
+			*strategy = (Pivot_Strategy)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void sorts_set_pivot_strategy(Pivot_Strategy strategy) {
+	g_pivot_strategy = strategy;
+}
+
+Pivot_Strategy sorts_pivot_strategy(void) {
+	return g_pivot_strategy;
+}
+
+// xorshift64*
+uint64_t pivot_next_random(uint64_t* random_state) {
+	uint64_t x = *random_state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*random_state = x;
+
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+PIVOT_DEFINE_SELECT(pivot_select_int64, int64_t)
+
+size_t pivot_select(int64_t* array, size_t low, size_t high, size_t default_index, Pivot_Strategy strategy, uint64_t* random_state) {
+	return pivot_select_int64(array, low, high, default_index, strategy, random_state);
+}
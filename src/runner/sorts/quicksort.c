@@ -0,0 +1,119 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sorts/sorts.h"
+#include "sorts/partition.h"
+#include "sorts/stats.h"
+
+typedef int64_t (*Partition_Function)(int64_t arr[], int64_t low, int64_t high);
+
+typedef struct {
+	Partition_Function partition_function;
+	Pivot_Strategy pivot_strategy;
+	uint64_t random_state;
+	Small_Sort_Leaf leaf;
+
+	// Recurse only into the smaller side, looping on the larger one
+	bool bound_stack;
+	size_t depth;
+	size_t peak_depth;
+} Quicksort_Context;
+
+static void swap(int64_t* a, int64_t* b) {
+	int64_t t = *a;
+	*a = *b;
+	*b = t;
+}
+
+static int64_t partition(int64_t arr[], int64_t low, int64_t high) {
+	int64_t pivot = arr[high];
+	int64_t i = low - 1;
+	for (int64_t j = low; j <= high - 1; j++) {
+		if (arr[j] < pivot) {
+			i++;
+			swap(&arr[i], &arr[j]);
+		}
+	}
+	swap(&arr[i + 1], &arr[high]);
+	return i + 1;
+}
+
+static int64_t partition_block(int64_t arr[], int64_t low, int64_t high) {
+	return low + (int64_t)block_partition(arr + low, (size_t)(high - low + 1));
+}
+
+static void quicksort_rec(int64_t arr[], int64_t low, int64_t high, Quicksort_Context* context) {
+	context->depth += 1;
+	if (context->depth > context->peak_depth) {
+		context->peak_depth = context->depth;
+	}
+
+	while (low < high) {
+		if ((size_t)(high - low + 1) <= context->leaf.cutoff) {
+			context->leaf.function(arr + low, (size_t)(high - low + 1));
+			break;
+		}
+
+		// Both partitions use the last element as pivot
+		size_t pivot_index = pivot_select(arr, (size_t)low, (size_t)high, (size_t)high,
+			context->pivot_strategy,
+			&context->random_state
+		);
+		swap(&arr[pivot_index], &arr[high]);
+
+		int64_t pi = context->partition_function(arr, low, high);
+
+		if (!context->bound_stack) {
+			quicksort_rec(arr, low, pi - 1, context);
+			quicksort_rec(arr, pi + 1, high, context);
+			break;
+		}
+
+		// The side recursed into is at most half of the current one, so the
+		// recursion is at most log2(n) deep whatever the pivots are
+		if (pi - low < high - pi) {
+			quicksort_rec(arr, low, pi - 1, context);
+			low = pi + 1;
+		} else {
+			quicksort_rec(arr, pi + 1, high, context);
+			high = pi - 1;
+		}
+	}
+
+	context->depth -= 1;
+}
+
+static void quicksort_with_partition(int64_t* array, size_t array_length, Partition_Function partition_function, bool bound_stack) {
+	Quicksort_Context context;
+	context.partition_function = partition_function;
+	context.pivot_strategy = sorts_pivot_strategy();
+	context.random_state = PIVOT_RANDOM_SEED;
+	// No leaf sort by default, partitioning down to single elements
+	context.leaf = sorts_small_sort_leaf(0);
+	context.bound_stack = bound_stack;
+	context.depth = 0;
+	context.peak_depth = 0;
+
+	if (array_length > 1) {
+		quicksort_rec(array, 0, (int64_t)array_length - 1, &context);
+	}
+
+	sortstats_record_recursion_depth(context.peak_depth);
+}
+
+void quicksort(int64_t* array, size_t array_length) {
+	quicksort_with_partition(array, array_length, partition, false);
+}
+
+void quicksort_block(int64_t* array, size_t array_length) {
+	quicksort_with_partition(array, array_length, partition_block, false);
+}
+
+void quicksort_tail(int64_t* array, size_t array_length) {
+	quicksort_with_partition(array, array_length, partition, true);
+}
+
+void quicksort_block_tail(int64_t* array, size_t array_length) {
+	quicksort_with_partition(array, array_length, partition_block, true);
+}
@@ -0,0 +1,112 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+#include "sorts/sorts.h"
+#include "sorts/partition.h"
+#include "sorts/stats.h"
+
+typedef struct {
+	Pivot_Strategy pivot_strategy;
+	uint64_t random_state;
+	Small_Sort_Leaf leaf;
+
+	// Recurse only into the smaller side, looping on the larger one
+	bool bound_stack;
+	size_t depth;
+	size_t peak_depth;
+} Qs3_Context;
+
+// Partitions a[lo..hi] in three parts: a[lo..lt-1] smaller than the pivot,
+// a[lt..gt] equal to it and a[gt+1..hi] greater
+static void qs3_partition(int64_t* a, ssize_t lo, ssize_t hi, Qs3_Context* context, ssize_t* out_lt, ssize_t* out_gt) {
+	size_t pivot_index = pivot_select(a, (size_t)lo, (size_t)hi, (size_t)lo,
+		context->pivot_strategy,
+		&context->random_state
+	);
+	int64_t pivot = a[pivot_index];
+	a[pivot_index] = a[lo];
+	a[lo] = pivot;
+
+	ssize_t lt = lo, i = lo + 1, gt = hi;
+	while (i <= gt) {
+		if (a[i] < pivot) {
+			int64_t tmp = a[lt];
+			a[lt++] = a[i];
+			a[i++] = tmp;
+		} else {
+			if (a[i] > pivot) {
+				int64_t tmp = a[i];
+				a[i] = a[gt];
+				a[gt--] = tmp;
+			} else {
+				i++;
+			}
+		}
+	}
+
+	*out_lt = lt;
+	*out_gt = gt;
+}
+
+static void qs3_rec(int64_t* a, ssize_t lo, ssize_t hi, Qs3_Context* context) {
+	context->depth += 1;
+	if (context->depth > context->peak_depth) {
+		context->peak_depth = context->depth;
+	}
+
+	while (lo < hi) {
+		if ((size_t)(hi - lo + 1) <= context->leaf.cutoff) {
+			context->leaf.function(a + lo, (size_t)(hi - lo + 1));
+			break;
+		}
+
+		ssize_t lt;
+		ssize_t gt;
+		qs3_partition(a, lo, hi, context, &lt, &gt);
+
+		if (!context->bound_stack) {
+			qs3_rec(a, lo, lt - 1, context);
+			qs3_rec(a, gt + 1, hi, context);
+			break;
+		}
+
+		// The side recursed into is at most half of the current one, so the
+		// recursion is at most log2(n) deep whatever the pivots are
+		if (lt - lo < hi - gt) {
+			qs3_rec(a, lo, lt - 1, context);
+			lo = gt + 1;
+		} else {
+			qs3_rec(a, gt + 1, hi, context);
+			hi = lt - 1;
+		}
+	}
+
+	context->depth -= 1;
+}
+
+static void quicksort_3way_with_options(int64_t* array, size_t array_length, bool bound_stack) {
+	Qs3_Context context;
+	context.pivot_strategy = sorts_pivot_strategy();
+	context.random_state = PIVOT_RANDOM_SEED;
+	// No leaf sort by default, partitioning down to single elements
+	context.leaf = sorts_small_sort_leaf(0);
+	context.bound_stack = bound_stack;
+	context.depth = 0;
+	context.peak_depth = 0;
+
+	if (array_length > 0) {
+		qs3_rec(array, 0, (ssize_t)array_length - 1, &context);
+	}
+
+	sortstats_record_recursion_depth(context.peak_depth);
+}
+
+void quicksort_3way(int64_t* array, size_t array_length) {
+	quicksort_3way_with_options(array, array_length, false);
+}
+
+void quicksort_3way_tail(int64_t* array, size_t array_length) {
+	quicksort_3way_with_options(array, array_length, true);
+}
@@ -0,0 +1,85 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "sorts/sorts.h"
+#include "sorts/stats.h"
+
+// Flips the sign bit, so that the unsigned order of the keys is the signed
+// order of the elements
+static uint64_t radixsort_key(int64_t element) {
+	return (uint64_t)element ^ 0x8000000000000000ULL;
+}
+
+static void radixsort_lsd(int64_t* array, size_t array_length, unsigned digit_bits) {
+	if (array_length < 2) {
+		return;
+	}
+
+	size_t pass_count = (64 + digit_bits - 1) / digit_bits;
+	size_t bucket_count = (size_t)1 << digit_bits;
+	uint64_t digit_mask = bucket_count - 1;
+
+	size_t* histograms = calloc(pass_count * bucket_count, sizeof(size_t));
+	int64_t* buffer = malloc(array_length * sizeof(int64_t));
+	assert(histograms != NULL && buffer != NULL);
+	sortstats_record_allocations(2);
+	sortstats_record_bytes(pass_count * bucket_count * sizeof(size_t) + array_length * sizeof(int64_t));
+
+	// The histograms of every digit are built in a single pass, as the counts
+	// of a digit do not depend on the order the previous passes leave
+	for (size_t i = 0; i < array_length; i += 1) {
+		uint64_t key = radixsort_key(array[i]);
+
+		for (size_t pass = 0; pass < pass_count; pass += 1) {
+			histograms[pass * bucket_count + ((key >> (pass * digit_bits)) & digit_mask)] += 1;
+		}
+	}
+
+	int64_t* source = array;
+	int64_t* destination = buffer;
+	for (size_t pass = 0; pass < pass_count; pass += 1) {
+		size_t* histogram = &histograms[pass * bucket_count];
+		unsigned shift = (unsigned)(pass * digit_bits);
+
+		// A digit that is the same for every key would only copy the array
+		size_t first_digit = (radixsort_key(source[0]) >> shift) & digit_mask;
+		if (histogram[first_digit] == array_length) {
+			continue;
+		}
+
+		size_t offset = 0;
+		for (size_t digit = 0; digit < bucket_count; digit += 1) {
+			size_t count = histogram[digit];
+			histogram[digit] = offset;
+			offset += count;
+		}
+
+		for (size_t i = 0; i < array_length; i += 1) {
+			size_t digit = (radixsort_key(source[i]) >> shift) & digit_mask;
+			destination[histogram[digit]] = source[i];
+			histogram[digit] += 1;
+		}
+
+		int64_t* tmp = source;
+		source = destination;
+		destination = tmp;
+	}
+
+	if (source != array) {
+		memcpy(array, source, array_length * sizeof(int64_t));
+	}
+
+	free(histograms);
+	free(buffer);
+}
+
+void radixsort(int64_t* array, size_t array_length) {
+	radixsort_lsd(array, array_length, 8);
+}
+
+void radixsort_11(int64_t* array, size_t array_length) {
+	radixsort_lsd(array, array_length, 11);
+}
@@ -0,0 +1,378 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#include "sorts/sorts.h"
+#include "sorts/records.h"
+#include "sorts/scan.h"
+#include "sorts/stats.h"
+
+#define RECORDS_INSERTION_SORT_CUTOFF 16
+
+static const char* g_record_layout_names[RECORDLAYOUT_COUNT] = {
+	"aos",
+	"soa",
+};
+
+const char* recordlayout_name(Record_Layout layout) {
+	assert(layout < RECORDLAYOUT_COUNT);
+	return g_record_layout_names[layout];
+}
+
+size_t recordarray_record_size(const Record_Array* records) {
+	return sizeof(int64_t) + records->payload_size;
+}
+
+int64_t recordarray_key(const Record_Array* records, size_t index) {
+	if (records->layout == RECORDLAYOUT_AOS) {
+		int64_t key;
+		memcpy(&key, records->records + index * recordarray_record_size(records), sizeof(int64_t));
+		return key;
+	}
+
+	return records->keys[index];
+}
+
+const unsigned char* recordarray_payload(const Record_Array* records, size_t index) {
+	if (records->layout == RECORDLAYOUT_AOS) {
+		return records->records + index * recordarray_record_size(records) + sizeof(int64_t);
+	}
+
+	return records->payloads + index * records->payload_size;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// STRIDED VIEW
+////////////////////////////////////////////////////////////////////////////////
+
+// Both layouts are a key and a payload at fixed strides, so a single sort
+// handles them
+typedef struct {
+	unsigned char* keys;
+	size_t key_stride;
+	unsigned char* payloads;
+	size_t payload_stride;
+	size_t payload_size;
+	// Ties are broken on the first payload word, which the indirect sort
+	// fills with the original index
+	bool stable_index;
+} Record_View;
+
+static Record_View records_view(Record_Array* records) {
+	Record_View view;
+	if (records->layout == RECORDLAYOUT_AOS) {
+		view.keys = records->records;
+		view.key_stride = recordarray_record_size(records);
+		view.payloads = records->records + sizeof(int64_t);
+		view.payload_stride = recordarray_record_size(records);
+	} else {
+		view.keys = (unsigned char*)records->keys;
+		view.key_stride = sizeof(int64_t);
+		view.payloads = records->payloads;
+		view.payload_stride = records->payload_size;
+	}
+	view.payload_size = records->payload_size;
+	view.stable_index = false;
+
+	return view;
+}
+
+static int64_t view_key(const Record_View* view, size_t index) {
+	int64_t key;
+	memcpy(&key, view->keys + index * view->key_stride, sizeof(int64_t));
+	return key;
+}
+
+static uint64_t view_first_word(const Record_View* view, size_t index) {
+	uint64_t word;
+	memcpy(&word, view->payloads + index * view->payload_stride, sizeof(uint64_t));
+	return word;
+}
+
+static bool view_less(const Record_View* view, size_t a, size_t b) {
+	int64_t key_a = view_key(view, a);
+	int64_t key_b = view_key(view, b);
+	if (key_a != key_b || !view->stable_index) {
+		return key_a < key_b;
+	}
+
+	return view_first_word(view, a) < view_first_word(view, b);
+}
+
+static void swap_words(unsigned char* a, unsigned char* b, size_t size) {
+	for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+		uint64_t word_a;
+		uint64_t word_b;
+		memcpy(&word_a, a + i, sizeof(uint64_t));
+		memcpy(&word_b, b + i, sizeof(uint64_t));
+		memcpy(a + i, &word_b, sizeof(uint64_t));
+		memcpy(b + i, &word_a, sizeof(uint64_t));
+	}
+}
+
+static void view_swap(const Record_View* view, size_t a, size_t b) {
+	swap_words(view->keys + a * view->key_stride, view->keys + b * view->key_stride, sizeof(int64_t));
+	swap_words(view->payloads + a * view->payload_stride, view->payloads + b * view->payload_stride, view->payload_size);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// INTROSORT
+////////////////////////////////////////////////////////////////////////////////
+
+static void view_insertion_sort(const Record_View* view, size_t start, size_t end) {
+	for (size_t i = start + 1; i < end; i += 1) {
+		for (size_t j = i; j > start && view_less(view, j, j - 1); j -= 1) {
+			view_swap(view, j, j - 1);
+		}
+	}
+}
+
+static void view_sift_down(const Record_View* view, size_t start, size_t root, size_t length) {
+	for (;;) {
+		size_t child = 2 * root + 1;
+		if (child >= length) {
+			return;
+		}
+		if (child + 1 < length && view_less(view, start + child, start + child + 1)) {
+			child += 1;
+		}
+		if (!view_less(view, start + root, start + child)) {
+			return;
+		}
+
+		view_swap(view, start + root, start + child);
+		root = child;
+	}
+}
+
+static void view_heapsort(const Record_View* view, size_t start, size_t end) {
+	size_t length = end - start;
+
+	for (size_t i = length / 2; i > 0; i -= 1) {
+		view_sift_down(view, start, i - 1, length);
+	}
+	for (size_t i = length - 1; i > 0; i -= 1) {
+		view_swap(view, start, start + i);
+		view_sift_down(view, start, 0, i);
+	}
+}
+
+// Moves the median of the first, middle and last records to start
+static void view_median_of_three(const Record_View* view, size_t start, size_t end) {
+	size_t middle = start + (end - start) / 2;
+	size_t last = end - 1;
+
+	if (view_less(view, middle, start)) {
+		view_swap(view, middle, start);
+	}
+	if (view_less(view, last, middle)) {
+		view_swap(view, last, middle);
+		if (view_less(view, middle, start)) {
+			view_swap(view, middle, start);
+		}
+	}
+	view_swap(view, start, middle);
+}
+
+// Hoare partition around the record in start, returns its final position
+static size_t view_partition(const Record_View* view, size_t start, size_t end) {
+	size_t i = start;
+	size_t j = end;
+
+	for (;;) {
+		do {
+			i += 1;
+		} while (i < end && view_less(view, i, start));
+		do {
+			j -= 1;
+		} while (view_less(view, start, j));
+
+		if (i >= j) {
+			break;
+		}
+		view_swap(view, i, j);
+	}
+
+	view_swap(view, start, j);
+	return j;
+}
+
+static void view_introsort(const Record_View* view, size_t start, size_t end, size_t max_depth, size_t depth, size_t* peak_depth) {
+	if (depth > *peak_depth) {
+		*peak_depth = depth;
+	}
+
+	while (end - start > RECORDS_INSERTION_SORT_CUTOFF) {
+		if (max_depth == 0) {
+			view_heapsort(view, start, end);
+			return;
+		}
+		max_depth -= 1;
+
+		view_median_of_three(view, start, end);
+		size_t p = view_partition(view, start, end);
+
+		// Recursing into the smaller side keeps the stack logarithmic
+		if (p - start < end - p - 1) {
+			view_introsort(view, start, p, max_depth, depth + 1, peak_depth);
+			start = p + 1;
+		} else {
+			view_introsort(view, p + 1, end, max_depth, depth + 1, peak_depth);
+			end = p;
+		}
+	}
+
+	view_insertion_sort(view, start, end);
+}
+
+static void view_sort(const Record_View* view, size_t count) {
+	if (count < 2) {
+		return;
+	}
+
+	size_t peak_depth = 0;
+	view_introsort(view, 0, count, (size_t)log2(count) * 2, 1, &peak_depth);
+	sortstats_record_recursion_depth(peak_depth);
+}
+
+void records_introsort(Record_Array* records) {
+	Record_View view = records_view(records);
+	view_sort(&view, records->count);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// INDIRECT SORT
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	int64_t key;
+	uint64_t index;
+} Record_Pair;
+
+void records_introsort_indirect(Record_Array* records) {
+	size_t count = records->count;
+	if (count < 2) {
+		return;
+	}
+
+	size_t record_size = recordarray_record_size(records);
+	size_t moved_size = records->layout == RECORDLAYOUT_AOS ? record_size : records->payload_size;
+
+	Record_Pair* pairs = malloc(count * sizeof(Record_Pair));
+	unsigned char* buffer = malloc(count * moved_size);
+	assert(pairs != NULL && buffer != NULL);
+	sortstats_record_allocations(2);
+	sortstats_record_bytes(count * (sizeof(Record_Pair) + moved_size));
+
+	for (size_t i = 0; i < count; i += 1) {
+		pairs[i].key = recordarray_key(records, i);
+		pairs[i].index = i;
+	}
+
+	Record_View view;
+	view.keys = (unsigned char*)pairs;
+	view.key_stride = sizeof(Record_Pair);
+	view.payloads = (unsigned char*)pairs + sizeof(int64_t);
+	view.payload_stride = sizeof(Record_Pair);
+	view.payload_size = sizeof(uint64_t);
+	view.stable_index = true;
+	view_sort(&view, count);
+
+	// Every payload is only moved here, once
+	if (records->layout == RECORDLAYOUT_AOS) {
+		for (size_t i = 0; i < count; i += 1) {
+			memcpy(buffer + i * record_size, records->records + pairs[i].index * record_size, record_size);
+		}
+		memcpy(records->records, buffer, count * record_size);
+	} else {
+		for (size_t i = 0; i < count; i += 1) {
+			records->keys[i] = pairs[i].key;
+			memcpy(buffer + i * records->payload_size, records->payloads + pairs[i].index * records->payload_size, records->payload_size);
+		}
+		memcpy(records->payloads, buffer, count * records->payload_size);
+	}
+
+	free(pairs);
+	free(buffer);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COUNTING SORT
+////////////////////////////////////////////////////////////////////////////////
+
+void records_countingsort(Record_Array* records) {
+	size_t count = records->count;
+	if (count < 2) {
+		return;
+	}
+
+	int64_t min_key;
+	int64_t max_key;
+	if (records->layout == RECORDLAYOUT_SOA) {
+		scan_min_max(records->keys, count, &min_key, &max_key);
+	} else {
+		min_key = INT64_MAX;
+		max_key = INT64_MIN;
+		for (size_t i = 0; i < count; i += 1) {
+			int64_t key = recordarray_key(records, i);
+			min_key = key < min_key ? key : min_key;
+			max_key = key > max_key ? key : max_key;
+		}
+	}
+
+	// Unsigned and compared before adding 1, as for countingsort_adaptive
+	uint64_t key_range = (uint64_t)max_key - (uint64_t)min_key;
+	size_t memory_cap = sorts_counting_memory_cap();
+	if ((memory_cap != 0 && key_range >= memory_cap / sizeof(uint64_t)) || key_range >= SIZE_MAX / sizeof(uint64_t)) {
+		records_introsort_indirect(records);
+		return;
+	}
+
+	size_t element_count = (size_t)key_range + 1;
+
+	size_t record_size = recordarray_record_size(records);
+	size_t buffer_size = records->layout == RECORDLAYOUT_AOS ? count * record_size : count * (sizeof(int64_t) + records->payload_size);
+
+	uint64_t* counts = calloc(element_count, sizeof(uint64_t));
+	unsigned char* buffer = malloc(buffer_size);
+	assert(counts != NULL && buffer != NULL);
+	sortstats_record_allocations(2);
+	sortstats_record_bytes(element_count * sizeof(uint64_t) + buffer_size);
+
+	for (size_t i = 0; i < count; i += 1) {
+		counts[recordarray_key(records, i) - min_key] += 1;
+	}
+	for (size_t i = 1; i < element_count; i += 1) {
+		counts[i] += counts[i - 1];
+	}
+
+	if (records->layout == RECORDLAYOUT_AOS) {
+		for (size_t i = count; i > 0; i -= 1) {
+			const unsigned char* record = records->records + (i - 1) * record_size;
+			size_t destination = --counts[recordarray_key(records, i - 1) - min_key];
+			memcpy(buffer + destination * record_size, record, record_size);
+		}
+		memcpy(records->records, buffer, count * record_size);
+	} else {
+		int64_t* keys = (int64_t*)buffer;
+		unsigned char* payloads = buffer + count * sizeof(int64_t);
+		for (size_t i = count; i > 0; i -= 1) {
+			size_t destination = --counts[records->keys[i - 1] - min_key];
+			keys[destination] = records->keys[i - 1];
+			memcpy(payloads + destination * records->payload_size, records->payloads + (i - 1) * records->payload_size, records->payload_size);
+		}
+		memcpy(records->keys, keys, count * sizeof(int64_t));
+		memcpy(records->payloads, payloads, count * records->payload_size);
+	}
+
+	free(counts);
+	free(buffer);
+}
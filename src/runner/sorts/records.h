@@ -0,0 +1,59 @@
+#ifndef SORTS_RECORDS_H
+#define SORTS_RECORDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// RECORDS
+////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+	// Every record is its key followed by its payload
+	RECORDLAYOUT_AOS,
+	// The keys and the payloads are two separate arrays
+	RECORDLAYOUT_SOA,
+
+	RECORDLAYOUT_COUNT,
+} Record_Layout;
+
+const char* recordlayout_name(Record_Layout layout);
+
+// count records with an int64_t key and payload_size bytes of payload, a
+// multiple of 8. Only the fields of the layout are used.
+typedef struct {
+	Record_Layout layout;
+	size_t count;
+	size_t payload_size;
+
+	// RECORDLAYOUT_AOS
+	unsigned char* records;
+
+	// RECORDLAYOUT_SOA
+	int64_t* keys;
+	unsigned char* payloads;
+} Record_Array;
+
+size_t recordarray_record_size(const Record_Array* records);
+int64_t recordarray_key(const Record_Array* records, size_t index);
+const unsigned char* recordarray_payload(const Record_Array* records, size_t index);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// RECORD SORTING FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+typedef void (*Record_Sort_Function)(Record_Array* records);
+
+// Introsort moving the whole records at every swap, not stable
+void records_introsort(Record_Array* records);
+// Sorts (key, index) pairs with the same introsort, breaking ties on the
+// index so that the order is stable, and then moves every payload once
+void records_introsort_indirect(Record_Array* records);
+// Stable counting sort moving every record once. Key ranges whose counters
+// would exceed sorts_counting_memory_cap() use records_introsort_indirect.
+void records_countingsort(Record_Array* records);
+
+#endif
@@ -0,0 +1,41 @@
+#include <string.h>
+
+#include "sorts/sorts.h"
+
+const Sort_Kernel g_sort_kernels[] = {
+	{ "countingsort",               "Counting Sort",                                 countingsort,          SORTKERNEL_DEFAULT,                                                                                NULL,                       NULL },
+	{ "countingsort_arena",         "Counting Sort (scratch arena)",                 countingsort_arena,    SORTKERNEL_DEFAULT,                                                                                NULL,                       NULL },
+	{ "countingsort_adaptive",      "Counting Sort (adaptive counters, memory cap)", countingsort_adaptive, SORTKERNEL_DEFAULT | SORTKERNEL_ELEMENT_TYPES,                                                     NULL,                       g_countingsort_adaptive_typed },
+	{ "countingsort_multi",         "Counting Sort (4 sub-histograms)",              countingsort_multi,    SORTKERNEL_DEFAULT,                                                                                NULL,                       NULL },
+	{ "countingsort_par",           "Parallel Counting Sort",                        countingsort_parallel, SORTKERNEL_DEFAULT | SORTKERNEL_PARALLEL,                                                          NULL,                       NULL },
+	{ "radixsort",                  "Radix Sort (8 bit digits)",                     radixsort,             SORTKERNEL_DEFAULT | SORTKERNEL_ELEMENT_TYPES,                                                     NULL,                       g_radixsort_typed },
+	{ "radixsort11",                "Radix Sort (11 bit digits)",                    radixsort_11,          SORTKERNEL_DEFAULT,                                                                                NULL,                       NULL },
+	{ "quicksort",                  "Quick Sort",                                    quicksort,             SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT | SORTKERNEL_ELEMENT_TYPES, NULL,                       g_quicksort_typed },
+	{ "quicksort3way",              "Quick Sort 3 Way",                              quicksort_3way,        SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT | SORTKERNEL_ELEMENT_TYPES, NULL,                       g_quicksort_3way_typed },
+	{ "introsort",                  "Intro Sort",                                    introsort,             SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT | SORTKERNEL_ELEMENT_TYPES, NULL,                       g_introsort_typed },
+	{ "quicksort_block",            "Quick Sort (block partition)",                  quicksort_block,       SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT,                            NULL,                       NULL },
+	{ "introsort_block",            "Intro Sort (block partition)",                  introsort_block,       SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT,                            NULL,                       NULL },
+	{ "quicksort_tail",             "Quick Sort (bounded stack)",                    quicksort_tail,        SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT,                            NULL,                       NULL },
+	{ "quicksort_block_tail",       "Quick Sort (block partition, bounded stack)",   quicksort_block_tail,  SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT,                            NULL,                       NULL },
+	{ "quicksort3way_tail",         "Quick Sort 3 Way (bounded stack)",              quicksort_3way_tail,   SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT,                            NULL,                       NULL },
+	{ "introsort_pdq",              "Intro Sort (pattern defeating)",                introsort_pdq,         SORTKERNEL_DEFAULT | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT,                            NULL,                       NULL },
+	{ "introsort_par",              "Parallel Intro Sort",                           introsort_parallel,    SORTKERNEL_DEFAULT | SORTKERNEL_PARALLEL | SORTKERNEL_PIVOT_STRATEGY | SORTKERNEL_SMALL_SORT,      NULL,                       NULL },
+	{ "samplesort_par",             "Parallel Sample Sort",                          samplesort_parallel,   SORTKERNEL_DEFAULT | SORTKERNEL_PARALLEL,                                                          NULL,                       NULL },
+	{ "mergesort_par",              "Parallel Multiway Merge Sort",                  mergesort_parallel,    SORTKERNEL_DEFAULT | SORTKERNEL_PARALLEL,                                                          NULL,                       NULL },
+	{ "records_introsort",          "Intro Sort (records)",                          NULL,                  SORTKERNEL_DEFAULT | SORTKERNEL_RECORDS,                                                           records_introsort,          NULL },
+	{ "records_introsort_indirect", "Intro Sort (records by index, stable)",         NULL,                  SORTKERNEL_DEFAULT | SORTKERNEL_RECORDS,                                                           records_introsort_indirect, NULL },
+	{ "records_countingsort",       "Counting Sort (records, stable)",               NULL,                  SORTKERNEL_DEFAULT | SORTKERNEL_RECORDS,                                                           records_countingsort,       NULL },
+	{ "stdsort",                    "Standard library sort (template)",              std_sort,              SORTKERNEL_ELEMENT_TYPES,                                                                          NULL,                       g_std_sort_typed },
+};
+
+const size_t g_sort_kernels_count = sizeof(g_sort_kernels) / sizeof(g_sort_kernels[0]);
+
+const Sort_Kernel* sortkernel_find(const char* name) {
+	for (size_t i = 0; i < g_sort_kernels_count; i += 1) {
+		if (strcmp(g_sort_kernels[i].name, name) == 0) {
+			return &g_sort_kernels[i];
+		}
+	}
+
+	return NULL;
+}
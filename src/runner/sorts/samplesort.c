@@ -0,0 +1,235 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "sorts/sorts.h"
+#include "sorts/task_pool.h"
+#include "sorts/partition.h"
+#include "sorts/stats.h"
+
+// Below this many elements per thread the array is sorted by one thread
+#define SAMPLESORT_MIN_CHUNK_LENGTH 65536
+// Buckets per thread, so that a few unlucky buckets do not leave the other
+// threads idle while they are sorted
+#define SAMPLESORT_BUCKETS_PER_THREAD 4
+// Most buckets, the classification tree must stay in the L1 cache
+#define SAMPLESORT_MAX_BUCKETS 256
+// Sample elements per bucket
+#define SAMPLESORT_OVERSAMPLING 32
+
+typedef struct Samplesort_Context Samplesort_Context;
+typedef void (*Samplesort_Phase)(Samplesort_Context* context, size_t index);
+
+struct Samplesort_Context {
+	int64_t* array;
+	size_t array_length;
+	size_t chunk_count;
+	Samplesort_Phase phase;
+	// Tasks of the current phase, one per chunk or one per bucket
+	size_t task_count;
+
+	// Splitters in the order of an implicit binary search tree: the children
+	// of tree[i] are tree[2i] and tree[2i + 1], tree[0] is unused
+	int64_t tree[SAMPLESORT_MAX_BUCKETS];
+	size_t bucket_count;
+	size_t tree_levels;
+
+	// Bucket of every element, written by the classification and read by
+	// the scatter so that the tree is only walked once
+	unsigned char* oracle;
+	// chunk_count * bucket_count: the size of every bucket in every chunk,
+	// then where the chunk writes its elements of every bucket
+	size_t* counts;
+	// Start of every bucket in buffer, bucket_count + 1 entries
+	size_t* bucket_starts;
+	int64_t* buffer;
+};
+
+static void samplesort_chunk_range(const Samplesort_Context* context, size_t index, size_t* start, size_t* end) {
+	*start = context->array_length * index / context->chunk_count;
+	*end = context->array_length * (index + 1) / context->chunk_count;
+}
+
+// Every level of the tree is one branchless step, the comparison only picking
+// the child
+static size_t samplesort_bucket(const Samplesort_Context* context, int64_t element) {
+	size_t node = 1;
+	for (size_t level = 0; level < context->tree_levels; level += 1) {
+		node = 2 * node + (element > context->tree[node]);
+	}
+
+	return node - context->bucket_count;
+}
+
+static void samplesort_classify(Samplesort_Context* context, size_t index) {
+	size_t start, end;
+	samplesort_chunk_range(context, index, &start, &end);
+
+	size_t* counts = &context->counts[index * context->bucket_count];
+	memset(counts, 0, context->bucket_count * sizeof(size_t));
+
+	for (size_t i = start; i < end; i += 1) {
+		size_t bucket = samplesort_bucket(context, context->array[i]);
+		context->oracle[i] = (unsigned char)bucket;
+		counts[bucket] += 1;
+	}
+}
+
+static void samplesort_scatter(Samplesort_Context* context, size_t index) {
+	size_t start, end;
+	samplesort_chunk_range(context, index, &start, &end);
+
+	size_t* offsets = &context->counts[index * context->bucket_count];
+	for (size_t i = start; i < end; i += 1) {
+		size_t bucket = context->oracle[i];
+		context->buffer[offsets[bucket]] = context->array[i];
+		offsets[bucket] += 1;
+	}
+}
+
+// Here index is a bucket, sorted in the buffer and copied back in place
+static void samplesort_sort_bucket(Samplesort_Context* context, size_t index) {
+	size_t start = context->bucket_starts[index];
+	size_t end = context->bucket_starts[index + 1];
+
+	introsort_pdq(context->buffer + start, end - start);
+	memcpy(context->array + start, context->buffer + start, (end - start) * sizeof(int64_t));
+}
+
+static void samplesort_task(Task_Pool* pool, size_t worker_index, Task task) {
+	(void)pool;
+	(void)worker_index;
+
+	Samplesort_Context* context = task.user_data;
+	context->phase(context, task.index);
+}
+
+static void samplesort_root(Task_Pool* pool, size_t worker_index, Task task) {
+	Samplesort_Context* context = task.user_data;
+
+	for (size_t i = 1; i < context->task_count; i += 1) {
+		Task spawned = task;
+		spawned.function = samplesort_task;
+		spawned.index = i;
+
+		taskpool_spawn(pool, worker_index, spawned);
+	}
+
+	context->phase(context, 0);
+}
+
+static void samplesort_run(Task_Pool* pool, Samplesort_Context* context, Samplesort_Phase phase, size_t task_count) {
+	context->phase = phase;
+	context->task_count = task_count;
+
+	Task root;
+	root.function = samplesort_root;
+	root.array = context->array;
+	root.array_length = context->array_length;
+	root.depth = 0;
+	root.index = 0;
+	root.user_data = context;
+
+	taskpool_run(pool, root);
+}
+
+// Picks bucket_count - 1 evenly spaced splitters out of a sorted random
+// sample, and lays them out as the classification tree
+static void samplesort_choose_splitters(Samplesort_Context* context) {
+	size_t sample_length = context->bucket_count * SAMPLESORT_OVERSAMPLING;
+	int64_t* sample = malloc(sample_length * sizeof(int64_t));
+	assert(sample != NULL);
+
+	uint64_t random_state = PIVOT_RANDOM_SEED;
+	for (size_t i = 0; i < sample_length; i += 1) {
+		sample[i] = context->array[pivot_next_random(&random_state) % context->array_length];
+	}
+	introsort(sample, sample_length);
+
+	// The in order traversal of the tree visits the splitters in order
+	size_t splitter = 0;
+	size_t node = 1;
+	size_t stack[SAMPLESORT_MAX_BUCKETS];
+	size_t stack_length = 0;
+	while (node < context->bucket_count || stack_length > 0) {
+		while (node < context->bucket_count) {
+			stack[stack_length] = node;
+			stack_length += 1;
+			node = 2 * node;
+		}
+
+		stack_length -= 1;
+		node = stack[stack_length];
+		splitter += 1;
+		context->tree[node] = sample[splitter * SAMPLESORT_OVERSAMPLING - 1];
+		node = 2 * node + 1;
+	}
+
+	free(sample);
+}
+
+void samplesort_parallel(int64_t* array, size_t array_length) {
+	size_t chunk_count = sorts_thread_count();
+	if (chunk_count > array_length / SAMPLESORT_MIN_CHUNK_LENGTH) {
+		chunk_count = array_length / SAMPLESORT_MIN_CHUNK_LENGTH;
+	}
+	if (chunk_count <= 1) {
+		introsort_pdq(array, array_length);
+		return;
+	}
+
+	Task_Pool* pool = sorts_task_pool();
+
+	Samplesort_Context context;
+	context.array = array;
+	context.array_length = array_length;
+	context.chunk_count = chunk_count;
+
+	// A power of two, so that the tree is complete
+	context.bucket_count = 2;
+	context.tree_levels = 1;
+	while (context.bucket_count < chunk_count * SAMPLESORT_BUCKETS_PER_THREAD && context.bucket_count < SAMPLESORT_MAX_BUCKETS) {
+		context.bucket_count *= 2;
+		context.tree_levels += 1;
+	}
+
+	samplesort_choose_splitters(&context);
+
+	context.oracle = malloc(array_length);
+	context.counts = malloc((chunk_count * context.bucket_count + context.bucket_count + 1) * sizeof(size_t));
+	context.buffer = malloc(array_length * sizeof(int64_t));
+	assert(context.oracle != NULL && context.counts != NULL && context.buffer != NULL);
+	context.bucket_starts = context.counts + chunk_count * context.bucket_count;
+	sortstats_record_allocations(4);
+	sortstats_record_bytes(
+		context.bucket_count * SAMPLESORT_OVERSAMPLING * sizeof(int64_t)
+		+ array_length
+		+ (chunk_count * context.bucket_count + context.bucket_count + 1) * sizeof(size_t)
+		+ array_length * sizeof(int64_t)
+	);
+
+	samplesort_run(pool, &context, samplesort_classify, chunk_count);
+
+	// Bucket by bucket, every chunk writes its elements after the ones of the
+	// chunks before it
+	size_t total = 0;
+	for (size_t bucket = 0; bucket < context.bucket_count; bucket += 1) {
+		context.bucket_starts[bucket] = total;
+		for (size_t chunk = 0; chunk < chunk_count; chunk += 1) {
+			size_t* count = &context.counts[chunk * context.bucket_count + bucket];
+			size_t chunk_bucket_length = *count;
+			*count = total;
+			total += chunk_bucket_length;
+		}
+	}
+	context.bucket_starts[context.bucket_count] = total;
+
+	samplesort_run(pool, &context, samplesort_scatter, chunk_count);
+	samplesort_run(pool, &context, samplesort_sort_bucket, context.bucket_count);
+
+	free(context.oracle);
+	free(context.counts);
+	free(context.buffer);
+}
@@ -0,0 +1,320 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "sorts/scan.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// The sortedness check tests this many elements between two early exits
+#define SCAN_SORTED_BLOCK_LENGTH 64
+
+typedef void (*Scan_Min_Max_Function)(const int64_t* array, size_t array_length, int64_t* min, int64_t* max);
+typedef bool (*Scan_Is_Sorted_Function)(const int64_t* array, size_t array_length);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SCALAR
+////////////////////////////////////////////////////////////////////////////////
+
+static void scan_min_max_scalar(const int64_t* array, size_t array_length, int64_t* min, int64_t* max) {
+	int64_t current_min = INT64_MAX;
+	int64_t current_max = INT64_MIN;
+
+	for (size_t i = 0; i < array_length; i += 1) {
+		if (array[i] < current_min) {
+			current_min = array[i];
+		}
+		if (array[i] > current_max) {
+			current_max = array[i];
+		}
+	}
+
+	*min = current_min;
+	*max = current_max;
+}
+
+static bool scan_is_sorted_scalar(const int64_t* array, size_t array_length) {
+	for (size_t i = 1; i < array_length; i += 1) {
+		if (array[i] < array[i - 1]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+#ifdef SCAN_X86
+////////////////////////////////////////////////////////////////////////////////
+// SSE4.2
+////////////////////////////////////////////////////////////////////////////////
+
+// pcmpgtq is the SSE4.2 part, the blends come from SSE4.1
+__attribute__((target("sse4.2")))
+static void scan_min_max_sse42(const int64_t* array, size_t array_length, int64_t* min, int64_t* max) {
+	__m128i min_0 = _mm_set1_epi64x(INT64_MAX);
+	__m128i min_1 = min_0;
+	__m128i max_0 = _mm_set1_epi64x(INT64_MIN);
+	__m128i max_1 = max_0;
+
+	size_t i = 0;
+	for (; i + 4 <= array_length; i += 4) {
+		__m128i values_0 = _mm_loadu_si128((const __m128i*)&array[i]);
+		__m128i values_1 = _mm_loadu_si128((const __m128i*)&array[i + 2]);
+
+		min_0 = _mm_blendv_epi8(min_0, values_0, _mm_cmpgt_epi64(min_0, values_0));
+		min_1 = _mm_blendv_epi8(min_1, values_1, _mm_cmpgt_epi64(min_1, values_1));
+		max_0 = _mm_blendv_epi8(max_0, values_0, _mm_cmpgt_epi64(values_0, max_0));
+		max_1 = _mm_blendv_epi8(max_1, values_1, _mm_cmpgt_epi64(values_1, max_1));
+	}
+
+	int64_t mins[4];
+	int64_t maxs[4];
+	_mm_storeu_si128((__m128i*)&mins[0], min_0);
+	_mm_storeu_si128((__m128i*)&mins[2], min_1);
+	_mm_storeu_si128((__m128i*)&maxs[0], max_0);
+	_mm_storeu_si128((__m128i*)&maxs[2], max_1);
+
+	scan_min_max_scalar(&array[i], array_length - i, min, max);
+	for (size_t j = 0; j < 4; j += 1) {
+		if (mins[j] < *min) {
+			*min = mins[j];
+		}
+		if (maxs[j] > *max) {
+			*max = maxs[j];
+		}
+	}
+}
+
+__attribute__((target("sse4.2")))
+static bool scan_is_sorted_sse42(const int64_t* array, size_t array_length) {
+	size_t i = 0;
+	while (i + SCAN_SORTED_BLOCK_LENGTH + 1 <= array_length) {
+		__m128i unsorted = _mm_setzero_si128();
+		for (size_t j = i; j < i + SCAN_SORTED_BLOCK_LENGTH; j += 2) {
+			__m128i current = _mm_loadu_si128((const __m128i*)&array[j]);
+			__m128i next = _mm_loadu_si128((const __m128i*)&array[j + 1]);
+			unsorted = _mm_or_si128(unsorted, _mm_cmpgt_epi64(current, next));
+		}
+		if (!_mm_testz_si128(unsorted, unsorted)) {
+			return false;
+		}
+
+		i += SCAN_SORTED_BLOCK_LENGTH;
+	}
+
+	return scan_is_sorted_scalar(&array[i], array_length - i);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2
+////////////////////////////////////////////////////////////////////////////////
+
+// Four independent chains hide the latency of the compare + blend
+__attribute__((target("avx2")))
+static void scan_min_max_avx2(const int64_t* array, size_t array_length, int64_t* min, int64_t* max) {
+	__m256i mins[4];
+	__m256i maxs[4];
+	for (size_t j = 0; j < 4; j += 1) {
+		mins[j] = _mm256_set1_epi64x(INT64_MAX);
+		maxs[j] = _mm256_set1_epi64x(INT64_MIN);
+	}
+
+	size_t i = 0;
+	for (; i + 16 <= array_length; i += 16) {
+		for (size_t j = 0; j < 4; j += 1) {
+			__m256i values = _mm256_loadu_si256((const __m256i*)&array[i + 4 * j]);
+
+			mins[j] = _mm256_blendv_epi8(mins[j], values, _mm256_cmpgt_epi64(mins[j], values));
+			maxs[j] = _mm256_blendv_epi8(maxs[j], values, _mm256_cmpgt_epi64(values, maxs[j]));
+		}
+	}
+
+	int64_t lane_mins[16];
+	int64_t lane_maxs[16];
+	for (size_t j = 0; j < 4; j += 1) {
+		_mm256_storeu_si256((__m256i*)&lane_mins[4 * j], mins[j]);
+		_mm256_storeu_si256((__m256i*)&lane_maxs[4 * j], maxs[j]);
+	}
+
+	scan_min_max_scalar(&array[i], array_length - i, min, max);
+	for (size_t j = 0; j < 16; j += 1) {
+		if (lane_mins[j] < *min) {
+			*min = lane_mins[j];
+		}
+		if (lane_maxs[j] > *max) {
+			*max = lane_maxs[j];
+		}
+	}
+}
+
+__attribute__((target("avx2")))
+static bool scan_is_sorted_avx2(const int64_t* array, size_t array_length) {
+	size_t i = 0;
+	while (i + SCAN_SORTED_BLOCK_LENGTH + 1 <= array_length) {
+		__m256i unsorted = _mm256_setzero_si256();
+		for (size_t j = i; j < i + SCAN_SORTED_BLOCK_LENGTH; j += 4) {
+			__m256i current = _mm256_loadu_si256((const __m256i*)&array[j]);
+			__m256i next = _mm256_loadu_si256((const __m256i*)&array[j + 1]);
+			unsorted = _mm256_or_si256(unsorted, _mm256_cmpgt_epi64(current, next));
+		}
+		if (!_mm256_testz_si256(unsorted, unsorted)) {
+			return false;
+		}
+
+		i += SCAN_SORTED_BLOCK_LENGTH;
+	}
+
+	return scan_is_sorted_scalar(&array[i], array_length - i);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX-512
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("avx512f")))
+static void scan_min_max_avx512(const int64_t* array, size_t array_length, int64_t* min, int64_t* max) {
+	__m512i min_0 = _mm512_set1_epi64(INT64_MAX);
+	__m512i min_1 = min_0;
+	__m512i max_0 = _mm512_set1_epi64(INT64_MIN);
+	__m512i max_1 = max_0;
+
+	size_t i = 0;
+	for (; i + 16 <= array_length; i += 16) {
+		__m512i values_0 = _mm512_loadu_si512((const void*)&array[i]);
+		__m512i values_1 = _mm512_loadu_si512((const void*)&array[i + 8]);
+
+		min_0 = _mm512_min_epi64(min_0, values_0);
+		min_1 = _mm512_min_epi64(min_1, values_1);
+		max_0 = _mm512_max_epi64(max_0, values_0);
+		max_1 = _mm512_max_epi64(max_1, values_1);
+	}
+
+	// Masked loads take the tail without a scalar loop
+	__mmask8 tail_0 = (__mmask8)((1u << (array_length - i < 8 ? array_length - i : 8)) - 1);
+	__mmask8 tail_1 = (__mmask8)((1u << (array_length - i > 8 ? array_length - i - 8 : 0)) - 1);
+	min_0 = _mm512_mask_min_epi64(min_0, tail_0, min_0, _mm512_maskz_loadu_epi64(tail_0, &array[i]));
+	max_0 = _mm512_mask_max_epi64(max_0, tail_0, max_0, _mm512_maskz_loadu_epi64(tail_0, &array[i]));
+	min_1 = _mm512_mask_min_epi64(min_1, tail_1, min_1, _mm512_maskz_loadu_epi64(tail_1, &array[i + 8]));
+	max_1 = _mm512_mask_max_epi64(max_1, tail_1, max_1, _mm512_maskz_loadu_epi64(tail_1, &array[i + 8]));
+
+	*min = _mm512_reduce_min_epi64(_mm512_min_epi64(min_0, min_1));
+	*max = _mm512_reduce_max_epi64(_mm512_max_epi64(max_0, max_1));
+}
+
+__attribute__((target("avx512f")))
+static bool scan_is_sorted_avx512(const int64_t* array, size_t array_length) {
+	size_t i = 0;
+	while (i + SCAN_SORTED_BLOCK_LENGTH + 1 <= array_length) {
+		__mmask8 unsorted = 0;
+		for (size_t j = i; j < i + SCAN_SORTED_BLOCK_LENGTH; j += 8) {
+			__m512i current = _mm512_loadu_si512((const void*)&array[j]);
+			__m512i next = _mm512_loadu_si512((const void*)&array[j + 1]);
+			unsorted |= _mm512_cmpgt_epi64_mask(current, next);
+		}
+		if (unsorted != 0) {
+			return false;
+		}
+
+		i += SCAN_SORTED_BLOCK_LENGTH;
+	}
+
+	return scan_is_sorted_scalar(&array[i], array_length - i);
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DISPATCH
+////////////////////////////////////////////////////////////////////////////////
+
+static const char* g_scan_isa_names[SCANISA_COUNT] = {
+	"scalar",
+	"sse4.2",
+	"avx2",
+	"avx512",
+};
+
+static const Scan_Min_Max_Function g_scan_min_max_functions[SCANISA_COUNT] = {
+	scan_min_max_scalar,
+#ifdef SCAN_X86
+	scan_min_max_sse42,
+	scan_min_max_avx2,
+	scan_min_max_avx512,
+#endif
+};
+
+static const Scan_Is_Sorted_Function g_scan_is_sorted_functions[SCANISA_COUNT] = {
+	scan_is_sorted_scalar,
+#ifdef SCAN_X86
+	scan_is_sorted_sse42,
+	scan_is_sorted_avx2,
+	scan_is_sorted_avx512,
+#endif
+};
+
+static Scan_Isa g_scan_isa = SCANISA_SCALAR;
+static pthread_once_t g_scan_isa_once = PTHREAD_ONCE_INIT;
+
+static void select_scan_isa(void) {
+	for (size_t i = SCANISA_COUNT; i > 0; i -= 1) {
+		if (scanisa_supported((Scan_Isa)(i - 1))) {
+			g_scan_isa = (Scan_Isa)(i - 1);
+			return;
+		}
+	}
+}
+
+const char* scanisa_name(Scan_Isa isa) {
+	assert(isa < SCANISA_COUNT);
+	return g_scan_isa_names[isa];
+}
+
+bool scanisa_supported(Scan_Isa isa) {
+	switch (isa) {
+	case SCANISA_SCALAR:
+		return true;
+#ifdef SCAN_X86
+	case SCANISA_SSE42:
+		return __builtin_cpu_supports("sse4.2");
+	case SCANISA_AVX2:
+		return __builtin_cpu_supports("avx2");
+	case SCANISA_AVX512:
+		return __builtin_cpu_supports("avx512f");
+#endif
+	default:
+		return false;
+	}
+}
+
+Scan_Isa scan_isa(void) {
+	pthread_once(&g_scan_isa_once, select_scan_isa);
+	return g_scan_isa;
+}
+
+void scan_min_max(const int64_t* array, size_t array_length, int64_t* min, int64_t* max) {
+	scan_min_max_isa(scan_isa(), array, array_length, min, max);
+}
+
+bool scan_is_sorted(const int64_t* array, size_t array_length) {
+	return scan_is_sorted_isa(scan_isa(), array, array_length);
+}
+
+void scan_min_max_isa(Scan_Isa isa, const int64_t* array, size_t array_length, int64_t* min, int64_t* max) {
+	assert(isa < SCANISA_COUNT && g_scan_min_max_functions[isa] != NULL);
+	assert(array_length > 0);
+	g_scan_min_max_functions[isa](array, array_length, min, max);
+}
+
+bool scan_is_sorted_isa(Scan_Isa isa, const int64_t* array, size_t array_length) {
+	assert(isa < SCANISA_COUNT && g_scan_is_sorted_functions[isa] != NULL);
+	return g_scan_is_sorted_functions[isa](array, array_length);
+}
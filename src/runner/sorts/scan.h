@@ -0,0 +1,39 @@
+#ifndef SORTS_SCAN_H
+#define SORTS_SCAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ARRAY SCANS
+////////////////////////////////////////////////////////////////////////////////
+
+// Instruction sets the scans are implemented with. The best one supported by
+// the cpu is chosen at the first call; on non x86 machines only the scalar one
+// is available.
+typedef enum {
+	SCANISA_SCALAR,
+	SCANISA_SSE42,
+	SCANISA_AVX2,
+	SCANISA_AVX512,
+
+	SCANISA_COUNT,
+} Scan_Isa;
+
+const char* scanisa_name(Scan_Isa isa);
+bool scanisa_supported(Scan_Isa isa);
+
+// Instruction set used by scan_min_max and scan_is_sorted
+Scan_Isa scan_isa(void);
+
+// array_length must be at least 1
+void scan_min_max(const int64_t* array, size_t array_length, int64_t* min, int64_t* max);
+bool scan_is_sorted(const int64_t* array, size_t array_length);
+
+// Same as above with the given instruction set, which must be supported
+void scan_min_max_isa(Scan_Isa isa, const int64_t* array, size_t array_length, int64_t* min, int64_t* max);
+bool scan_is_sorted_isa(Scan_Isa isa, const int64_t* array, size_t array_length);
+
+#endif
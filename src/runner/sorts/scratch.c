@@ -0,0 +1,146 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "sorts/scratch.h"
+#include "sorts/stats.h"
+
+struct Scratch_Overflow_Block {
+	Scratch_Overflow_Block* next;
+};
+
+static size_t align_size(size_t size) {
+	return (size + SCRATCH_ARENA_ALIGNMENT - 1) & ~(size_t)(SCRATCH_ARENA_ALIGNMENT - 1);
+}
+
+static unsigned char* align_pointer(unsigned char* pointer) {
+	return (unsigned char*)align_size((size_t)(uintptr_t)pointer);
+}
+
+static unsigned char* allocate_memory(size_t capacity) {
+	// Over-allocated by one alignment so that the usable part can be aligned
+	unsigned char* memory = malloc(capacity + SCRATCH_ARENA_ALIGNMENT);
+	assert(memory != NULL);
+	sortstats_record_allocations(1);
+
+	return memory;
+}
+
+void scratcharena_create(Scratch_Arena* arena, size_t initial_capacity) {
+	arena->capacity = align_size(initial_capacity);
+	arena->memory = arena->capacity > 0 ? allocate_memory(arena->capacity) : NULL;
+	arena->used = 0;
+
+	arena->overflow_blocks = NULL;
+	arena->overflow_bytes = 0;
+}
+
+static void free_overflow_blocks(Scratch_Arena* arena) {
+	while (arena->overflow_blocks != NULL) {
+		Scratch_Overflow_Block* next = arena->overflow_blocks->next;
+		free(arena->overflow_blocks);
+		arena->overflow_blocks = next;
+	}
+}
+
+void scratcharena_destroy(Scratch_Arena* arena) {
+	free_overflow_blocks(arena);
+	free(arena->memory);
+
+	arena->memory = NULL;
+	arena->capacity = 0;
+	arena->used = 0;
+	arena->overflow_bytes = 0;
+}
+
+void* scratcharena_alloc(Scratch_Arena* arena, size_t size) {
+	size = align_size(size);
+
+	if (arena->capacity - arena->used >= size) {
+		void* allocation = align_pointer(arena->memory) + arena->used;
+		arena->used += size;
+		return allocation;
+	}
+
+	size_t header_size = align_size(sizeof(Scratch_Overflow_Block));
+	Scratch_Overflow_Block* block = (Scratch_Overflow_Block*)allocate_memory(header_size + size);
+	block->next = arena->overflow_blocks;
+	arena->overflow_blocks = block;
+	arena->overflow_bytes += size;
+
+	return align_pointer((unsigned char*)block) + header_size;
+}
+
+void scratcharena_reset(Scratch_Arena* arena) {
+	sortstats_record_bytes(arena->used + arena->overflow_bytes);
+	arena->used = 0;
+
+	if (arena->overflow_blocks == NULL) {
+		return;
+	}
+
+	free_overflow_blocks(arena);
+
+	// Grown so that everything allocated since the last reset would fit, and
+	// at least doubled so that slowly growing workloads settle quickly
+	free(arena->memory);
+	size_t doubled_capacity = arena->capacity * 2;
+	arena->capacity += arena->overflow_bytes;
+	if (arena->capacity < doubled_capacity) {
+		arena->capacity = doubled_capacity;
+	}
+	arena->memory = allocate_memory(arena->capacity);
+	arena->overflow_bytes = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// THREAD ARENA
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	Scratch_Arena* current;
+	Scratch_Arena owned;
+} Thread_Scratch;
+
+static pthread_key_t g_scratch_key;
+static pthread_once_t g_scratch_key_once = PTHREAD_ONCE_INIT;
+
+static void destroy_thread_scratch(void* user_data) {
+	Thread_Scratch* thread_scratch = user_data;
+
+	scratcharena_destroy(&thread_scratch->owned);
+	free(thread_scratch);
+}
+
+static void create_scratch_key(void) {
+	int result = pthread_key_create(&g_scratch_key, destroy_thread_scratch);
+	assert(result == 0);
+}
+
+static Thread_Scratch* get_thread_scratch(void) {
+	pthread_once(&g_scratch_key_once, create_scratch_key);
+
+	Thread_Scratch* thread_scratch = pthread_getspecific(g_scratch_key);
+	if (thread_scratch == NULL) {
+		thread_scratch = malloc(sizeof(Thread_Scratch));
+		assert(thread_scratch != NULL);
+		scratcharena_create(&thread_scratch->owned, 0);
+		thread_scratch->current = &thread_scratch->owned;
+
+		pthread_setspecific(g_scratch_key, thread_scratch);
+	}
+
+	return thread_scratch;
+}
+
+void sorts_set_thread_scratch(Scratch_Arena* arena) {
+	Thread_Scratch* thread_scratch = get_thread_scratch();
+	thread_scratch->current = arena != NULL ? arena : &thread_scratch->owned;
+}
+
+Scratch_Arena* sorts_thread_scratch(void) {
+	return get_thread_scratch()->current;
+}
@@ -0,0 +1,51 @@
+#ifndef SORTS_SCRATCH_H
+#define SORTS_SCRATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SCRATCH ARENA
+////////////////////////////////////////////////////////////////////////////////
+
+// Every allocation is aligned to a cache line
+#define SCRATCH_ARENA_ALIGNMENT 64
+
+typedef struct Scratch_Overflow_Block Scratch_Overflow_Block;
+
+// Bump allocator for the temporary buffers of the kernels. Allocations that do
+// not fit in the current memory get a block of their own; at the next reset
+// those blocks are freed and the memory grows to hold all of them, so that a
+// workload of constant size stops allocating after its first call.
+typedef struct {
+	unsigned char* memory;
+	size_t capacity;
+	size_t used;
+
+	Scratch_Overflow_Block* overflow_blocks;
+	size_t overflow_bytes;
+} Scratch_Arena;
+
+// initial_capacity may be 0, in which case the first allocation will create
+// the memory
+void scratcharena_create(Scratch_Arena* arena, size_t initial_capacity);
+void scratcharena_destroy(Scratch_Arena* arena);
+
+// Returned memory is valid until the next scratcharena_reset
+void* scratcharena_alloc(Scratch_Arena* arena, size_t size);
+void scratcharena_reset(Scratch_Arena* arena);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// THREAD ARENA
+////////////////////////////////////////////////////////////////////////////////
+
+// Arena used by the registered kernels that take their buffers from a scratch
+// arena. The caller keeps ownership of the given arena, which must outlive its
+// use by the calling thread. NULL goes back to an arena owned by the thread,
+// created lazily.
+void sorts_set_thread_scratch(Scratch_Arena* arena);
+Scratch_Arena* sorts_thread_scratch(void);
+
+#endif
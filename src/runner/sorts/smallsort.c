@@ -0,0 +1,456 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "sorts/smallsort.h"
+#include "sorts/scan.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SMALLSORT_X86 1
+#include <immintrin.h>
+#endif
+
+// More than the comparators of the networks of every length, 2625
+#define SMALLSORT_NETWORK_CAPACITY 4096
+
+static const char* g_small_sort_names[SMALLSORT_COUNT] = {
+	"default",
+	"insertion",
+	"network",
+	"simd",
+};
+
+static Small_Sort g_small_sort = SMALLSORT_DEFAULT;
+static size_t g_small_sort_cutoff = SMALLSORT_DEFAULT_CUTOFF;
+
+const char* smallsort_name(Small_Sort sort) {
+	assert(sort < SMALLSORT_COUNT);
+	return g_small_sort_names[sort];
+}
+
+bool smallsort_parse(const char* name, Small_Sort* sort) {
+	for (size_t i = 0; i < SMALLSORT_COUNT; i += 1) {
+		if (strcmp(g_small_sort_names[i], name) == 0) {
+			*sort = (Small_Sort)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// INSERTION SORT
+////////////////////////////////////////////////////////////////////////////////
+
+void small_sort_insertion(int64_t* array, size_t array_length) {
+	for (size_t i = 1; i < array_length; i += 1) {
+		int64_t key = array[i];
+		size_t j = i;
+
+		while (j > 0 && array[j - 1] > key) {
+			array[j] = array[j - 1];
+			j -= 1;
+		}
+		array[j] = key;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SORTING NETWORKS
+////////////////////////////////////////////////////////////////////////////////
+
+// The network of length n is g_network_comparators[g_network_offsets[n]] up to
+// g_network_comparators[g_network_offsets[n + 1]]
+static Network_Comparator g_network_comparators[SMALLSORT_NETWORK_CAPACITY];
+static size_t g_network_offsets[SMALLSORT_MAX_LENGTH + 2];
+static pthread_once_t g_networks_once = PTHREAD_ONCE_INIT;
+
+// Batcher's odd-even merge sort of the next power of two. Padding the array
+// with maximums would leave them in place and make every comparator touching
+// them a no op, so those comparators are left out instead.
+static void build_networks(void) {
+	size_t count = 0;
+
+	for (size_t length = 0; length <= SMALLSORT_MAX_LENGTH; length += 1) {
+		g_network_offsets[length] = count;
+
+		size_t size = 1;
+		while (size < length) {
+			size *= 2;
+		}
+
+		for (size_t p = 1; p < size; p *= 2) {
+			for (size_t k = p; k >= 1; k /= 2) {
+				for (size_t j = k % p; j + k < size; j += 2 * k) {
+					for (size_t i = 0; i < k && i + j + k < length; i += 1) {
+						if ((i + j) / (p * 2) == (i + j + k) / (p * 2)) {
+							assert(count < SMALLSORT_NETWORK_CAPACITY);
+							g_network_comparators[count].low = (unsigned char)(i + j);
+							g_network_comparators[count].high = (unsigned char)(i + j + k);
+							count += 1;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	g_network_offsets[SMALLSORT_MAX_LENGTH + 1] = count;
+}
+
+// Compiles to conditional moves, so the comparison never drives a branch
+static void compare_exchange(int64_t* low, int64_t* high) {
+	int64_t a = *low;
+	int64_t b = *high;
+	bool greater = a > b;
+
+	*low = greater ? b : a;
+	*high = greater ? a : b;
+}
+
+// The networks must be built
+static void network_sort(int64_t* array, size_t array_length) {
+	assert(array_length <= SMALLSORT_MAX_LENGTH);
+
+	const Network_Comparator* comparator = &g_network_comparators[g_network_offsets[array_length]];
+	const Network_Comparator* end = &g_network_comparators[g_network_offsets[array_length + 1]];
+	for (; comparator < end; comparator += 1) {
+		compare_exchange(&array[comparator->low], &array[comparator->high]);
+	}
+}
+
+void small_sort_network(int64_t* array, size_t array_length) {
+	pthread_once(&g_networks_once, build_networks);
+	network_sort(array, array_length);
+}
+
+const Network_Comparator* smallsort_networks(const size_t** offsets) {
+	pthread_once(&g_networks_once, build_networks);
+
+	*offsets = g_network_offsets;
+	return g_network_comparators;
+}
+
+
+#ifdef SMALLSORT_X86
+////////////////////////////////////////////////////////////////////////////////
+// AVX2
+////////////////////////////////////////////////////////////////////////////////
+
+// Bitonic networks on registers of 4 elements, up to 8 registers: every
+// register is sorted, then runs of registers are merged two by two. The arrays
+// are padded with maximums, which stay at the end.
+
+__attribute__((target("avx2")))
+static __m256i avx2_min(__m256i a, __m256i b) {
+	return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+}
+
+__attribute__((target("avx2")))
+static __m256i avx2_max(__m256i a, __m256i b) {
+	return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+}
+
+// Sorts a bitonic register
+__attribute__((target("avx2")))
+static __m256i avx2_merge_register(__m256i v) {
+	__m256i other = _mm256_permute4x64_epi64(v, 0x4E); // lane ^ 2
+	v = _mm256_blend_epi32(avx2_min(v, other), avx2_max(v, other), 0xF0);
+	other = _mm256_permute4x64_epi64(v, 0xB1); // lane ^ 1
+	v = _mm256_blend_epi32(avx2_min(v, other), avx2_max(v, other), 0xCC);
+
+	return v;
+}
+
+__attribute__((target("avx2")))
+static __m256i avx2_sort_register(__m256i v) {
+	// Pairs in alternating directions make a bitonic register
+	__m256i other = _mm256_permute4x64_epi64(v, 0xB1);
+	v = _mm256_blend_epi32(avx2_min(v, other), avx2_max(v, other), 0x3C);
+
+	return avx2_merge_register(v);
+}
+
+__attribute__((target("avx2")))
+static __m256i avx2_reverse(__m256i v) {
+	return _mm256_permute4x64_epi64(v, 0x1B);
+}
+
+// Sorts count registers holding a bitonic sequence
+__attribute__((target("avx2")))
+static void avx2_merge_registers(__m256i* v, size_t count) {
+	for (size_t distance = count / 2; distance > 0; distance /= 2) {
+		for (size_t i = 0; i < count; i += 1) {
+			if ((i & distance) == 0) {
+				__m256i low = avx2_min(v[i], v[i + distance]);
+				v[i + distance] = avx2_max(v[i], v[i + distance]);
+				v[i] = low;
+			}
+		}
+	}
+	for (size_t i = 0; i < count; i += 1) {
+		v[i] = avx2_merge_register(v[i]);
+	}
+}
+
+// Sorts count registers. Always inlined with a constant count, so that the
+// loops are unrolled and the registers are never spilled
+__attribute__((target("avx2"), always_inline))
+static inline void avx2_sort_registers(__m256i* v, size_t count) {
+	for (size_t i = 0; i < count; i += 1) {
+		v[i] = avx2_sort_register(v[i]);
+	}
+	for (size_t run = 1; run < count; run *= 2) {
+		for (size_t start = 0; start < count; start += 2 * run) {
+			// The first run followed by the second one reversed is bitonic, and
+			// so are the halves the half cleaner splits it in
+			__m256i reversed[SMALLSORT_MAX_LENGTH / 4];
+			for (size_t i = 0; i < run; i += 1) {
+				reversed[i] = avx2_reverse(v[start + 2 * run - 1 - i]);
+			}
+			for (size_t i = 0; i < run; i += 1) {
+				v[start + run + i] = avx2_max(v[start + i], reversed[i]);
+				v[start + i] = avx2_min(v[start + i], reversed[i]);
+			}
+
+			avx2_merge_registers(&v[start], run);
+			avx2_merge_registers(&v[start + run], run);
+		}
+	}
+}
+
+__attribute__((target("avx2")))
+static void small_sort_avx2(int64_t* array, size_t array_length) {
+	assert(array_length <= SMALLSORT_MAX_LENGTH);
+	if (array_length < 2) {
+		return;
+	}
+
+	__m256i v[SMALLSORT_MAX_LENGTH / 4];
+	size_t count = 1;
+	while (count * 4 < array_length) {
+		count *= 2;
+	}
+
+	__m256i lanes = _mm256_setr_epi64x(0, 1, 2, 3);
+	__m256i padding = _mm256_set1_epi64x(INT64_MAX);
+	for (size_t i = 0; i < count; i += 1) {
+		v[i] = padding;
+		if (i * 4 < array_length) {
+			__m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x((int64_t)(array_length - i * 4)), lanes);
+			v[i] = _mm256_blendv_epi8(padding, _mm256_maskload_epi64((const long long*)&array[i * 4], mask), mask);
+		}
+	}
+
+	switch (count) {
+	case 1: avx2_sort_registers(v, 1); break;
+	case 2: avx2_sort_registers(v, 2); break;
+	case 4: avx2_sort_registers(v, 4); break;
+	case 8: avx2_sort_registers(v, 8); break;
+	default: abort();
+	}
+
+	for (size_t i = 0; i * 4 < array_length; i += 1) {
+		__m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x((int64_t)(array_length - i * 4)), lanes);
+		_mm256_maskstore_epi64((long long*)&array[i * 4], mask, v[i]);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX-512
+////////////////////////////////////////////////////////////////////////////////
+
+// Same networks on registers of 8 elements, up to 4 registers
+
+// Every lane is compared with the one partner selects, the lanes in max_lanes
+// keeping the larger element
+__attribute__((target("avx512f")))
+static __m512i avx512_exchange(__m512i v, __m512i partner, __mmask8 max_lanes) {
+	__m512i other = _mm512_permutexvar_epi64(partner, v);
+	return _mm512_mask_blend_epi64(max_lanes, _mm512_min_epi64(v, other), _mm512_max_epi64(v, other));
+}
+
+__attribute__((target("avx512f")))
+static __m512i avx512_merge_register(__m512i v) {
+	v = avx512_exchange(v, _mm512_set_epi64(3, 2, 1, 0, 7, 6, 5, 4), 0xF0);
+	v = avx512_exchange(v, _mm512_set_epi64(5, 4, 7, 6, 1, 0, 3, 2), 0xCC);
+	v = avx512_exchange(v, _mm512_set_epi64(6, 7, 4, 5, 2, 3, 0, 1), 0xAA);
+
+	return v;
+}
+
+__attribute__((target("avx512f")))
+static __m512i avx512_sort_register(__m512i v) {
+	v = avx512_exchange(v, _mm512_set_epi64(6, 7, 4, 5, 2, 3, 0, 1), 0x66);
+	v = avx512_exchange(v, _mm512_set_epi64(5, 4, 7, 6, 1, 0, 3, 2), 0x3C);
+	v = avx512_exchange(v, _mm512_set_epi64(6, 7, 4, 5, 2, 3, 0, 1), 0x5A);
+
+	return avx512_merge_register(v);
+}
+
+__attribute__((target("avx512f")))
+static __m512i avx512_reverse(__m512i v) {
+	return _mm512_permutexvar_epi64(_mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7), v);
+}
+
+__attribute__((target("avx512f")))
+static void avx512_merge_registers(__m512i* v, size_t count) {
+	for (size_t distance = count / 2; distance > 0; distance /= 2) {
+		for (size_t i = 0; i < count; i += 1) {
+			if ((i & distance) == 0) {
+				__m512i low = _mm512_min_epi64(v[i], v[i + distance]);
+				v[i + distance] = _mm512_max_epi64(v[i], v[i + distance]);
+				v[i] = low;
+			}
+		}
+	}
+	for (size_t i = 0; i < count; i += 1) {
+		v[i] = avx512_merge_register(v[i]);
+	}
+}
+
+// Sorts count registers. Always inlined with a constant count, so that the
+// loops are unrolled and the registers are never spilled
+__attribute__((target("avx512f"), always_inline))
+static inline void avx512_sort_registers(__m512i* v, size_t count) {
+	for (size_t i = 0; i < count; i += 1) {
+		v[i] = avx512_sort_register(v[i]);
+	}
+	for (size_t run = 1; run < count; run *= 2) {
+		for (size_t start = 0; start < count; start += 2 * run) {
+			__m512i reversed[SMALLSORT_MAX_LENGTH / 8];
+			for (size_t i = 0; i < run; i += 1) {
+				reversed[i] = avx512_reverse(v[start + 2 * run - 1 - i]);
+			}
+			for (size_t i = 0; i < run; i += 1) {
+				v[start + run + i] = _mm512_max_epi64(v[start + i], reversed[i]);
+				v[start + i] = _mm512_min_epi64(v[start + i], reversed[i]);
+			}
+
+			avx512_merge_registers(&v[start], run);
+			avx512_merge_registers(&v[start + run], run);
+		}
+	}
+}
+
+__attribute__((target("avx512f")))
+static void small_sort_avx512(int64_t* array, size_t array_length) {
+	assert(array_length <= SMALLSORT_MAX_LENGTH);
+	if (array_length < 2) {
+		return;
+	}
+
+	__m512i v[SMALLSORT_MAX_LENGTH / 8];
+	size_t count = 1;
+	while (count * 8 < array_length) {
+		count *= 2;
+	}
+
+	// Masked loads and stores take the tail, the masked out lanes are padding
+	__m512i padding = _mm512_set1_epi64(INT64_MAX);
+	for (size_t i = 0; i < count; i += 1) {
+		v[i] = padding;
+		if (i * 8 < array_length) {
+			size_t remaining = array_length - i * 8;
+			__mmask8 mask = (__mmask8)(remaining >= 8 ? 0xFF : (1u << remaining) - 1);
+			v[i] = _mm512_mask_loadu_epi64(padding, mask, &array[i * 8]);
+		}
+	}
+
+	switch (count) {
+	case 1: avx512_sort_registers(v, 1); break;
+	case 2: avx512_sort_registers(v, 2); break;
+	case 4: avx512_sort_registers(v, 4); break;
+	default: abort();
+	}
+
+	for (size_t i = 0; i * 8 < array_length; i += 1) {
+		size_t remaining = array_length - i * 8;
+		__mmask8 mask = (__mmask8)(remaining >= 8 ? 0xFF : (1u << remaining) - 1);
+		_mm512_mask_storeu_epi64(&array[i * 8], mask, v[i]);
+	}
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DISPATCH
+////////////////////////////////////////////////////////////////////////////////
+
+static Scan_Isa g_small_sort_isa = SCANISA_SCALAR;
+static Small_Sort_Function g_small_sort_simd = network_sort;
+static pthread_once_t g_small_sort_isa_once = PTHREAD_ONCE_INIT;
+
+static void select_small_sort_isa(void) {
+	pthread_once(&g_networks_once, build_networks);
+
+#ifdef SMALLSORT_X86
+	if (scanisa_supported(SCANISA_AVX512)) {
+		g_small_sort_isa = SCANISA_AVX512;
+		g_small_sort_simd = small_sort_avx512;
+	} else if (scanisa_supported(SCANISA_AVX2)) {
+		g_small_sort_isa = SCANISA_AVX2;
+		g_small_sort_simd = small_sort_avx2;
+	}
+#endif
+}
+
+Scan_Isa smallsort_isa(void) {
+	pthread_once(&g_small_sort_isa_once, select_small_sort_isa);
+	return g_small_sort_isa;
+}
+
+void small_sort_simd(int64_t* array, size_t array_length) {
+	pthread_once(&g_small_sort_isa_once, select_small_sort_isa);
+	g_small_sort_simd(array, array_length);
+}
+
+void sorts_set_small_sort(Small_Sort sort, size_t cutoff) {
+	assert(sort < SMALLSORT_COUNT);
+	assert(cutoff >= 2 && cutoff <= SMALLSORT_MAX_LENGTH);
+
+	g_small_sort = sort;
+	g_small_sort_cutoff = cutoff;
+}
+
+Small_Sort sorts_small_sort(void) {
+	return g_small_sort;
+}
+
+size_t sorts_small_sort_cutoff(void) {
+	return g_small_sort_cutoff;
+}
+
+Small_Sort_Leaf sorts_small_sort_leaf(size_t default_cutoff) {
+	Small_Sort_Leaf leaf;
+	leaf.cutoff = g_small_sort_cutoff;
+
+	// The hot path calls the sorts directly, without going through the once
+	switch (g_small_sort) {
+	case SMALLSORT_INSERTION:
+		leaf.function = small_sort_insertion;
+		break;
+	case SMALLSORT_NETWORK:
+		pthread_once(&g_networks_once, build_networks);
+		leaf.function = network_sort;
+		break;
+	case SMALLSORT_SIMD:
+		pthread_once(&g_small_sort_isa_once, select_small_sort_isa);
+		leaf.function = g_small_sort_simd;
+		break;
+	default:
+		leaf.function = NULL;
+		leaf.cutoff = default_cutoff;
+		break;
+	}
+
+	return leaf;
+}
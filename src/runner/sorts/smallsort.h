@@ -0,0 +1,77 @@
+#ifndef SORTS_SMALLSORT_H
+#define SORTS_SMALLSORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sorts/scan.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SMALL SORTS
+////////////////////////////////////////////////////////////////////////////////
+
+// Longest array the small sorts take
+#define SMALLSORT_MAX_LENGTH 32
+// Cutoff of the leaf sorts other than SMALLSORT_DEFAULT when none is given
+#define SMALLSORT_DEFAULT_CUTOFF 16
+
+typedef enum {
+	// The original leaf of every kernel: insertion sort below 16 elements for
+	// introsort, none for the quicksorts
+	SMALLSORT_DEFAULT,
+	SMALLSORT_INSERTION,
+	// Branchless compare-exchanges of Batcher's odd-even merge sort network
+	SMALLSORT_NETWORK,
+	// Bitonic network on AVX-512 or AVX2 registers, SMALLSORT_NETWORK where
+	// neither is available
+	SMALLSORT_SIMD,
+
+	SMALLSORT_COUNT,
+} Small_Sort;
+
+typedef void (*Small_Sort_Function)(int64_t* array, size_t array_length);
+
+const char* smallsort_name(Small_Sort sort);
+bool smallsort_parse(const char* name, Small_Sort* sort);
+
+// Instruction set of SMALLSORT_SIMD, SCANISA_SCALAR when it falls back to the
+// network
+Scan_Isa smallsort_isa(void);
+
+// array_length must be at most SMALLSORT_MAX_LENGTH
+void small_sort_insertion(int64_t* array, size_t array_length);
+void small_sort_network(int64_t* array, size_t array_length);
+void small_sort_simd(int64_t* array, size_t array_length);
+
+typedef struct {
+	unsigned char low;
+	unsigned char high;
+} Network_Comparator;
+
+// The comparators of the networks of small_sort_network, built on the first
+// call: the network of length n is comparators[offsets[n]] up to
+// comparators[offsets[n + 1]], so that the other element types can be sorted by
+// the same networks
+const Network_Comparator* smallsort_networks(const size_t** offsets);
+
+// Leaf sort of the kernels that support it, applied to the partitions of at
+// most cutoff (2 to SMALLSORT_MAX_LENGTH) elements. Read once at the start of
+// every sort, so it must not be changed while a kernel is running.
+void sorts_set_small_sort(Small_Sort sort, size_t cutoff);
+Small_Sort sorts_small_sort(void);
+size_t sorts_small_sort_cutoff(void);
+
+typedef struct {
+	// NULL with SMALLSORT_DEFAULT, the kernel keeping its own leaf
+	Small_Sort_Function function;
+	// Partitions of at most cutoff elements are leaves, 0 for none
+	size_t cutoff;
+} Small_Sort_Leaf;
+
+// The current leaf sort, default_cutoff being the one of the kernel with
+// SMALLSORT_DEFAULT
+Small_Sort_Leaf sorts_small_sort_leaf(size_t default_cutoff);
+
+#endif
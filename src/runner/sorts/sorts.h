@@ -0,0 +1,124 @@
+#ifndef SORTS_SORTS_H
+#define SORTS_SORTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sorts/scratch.h"
+#include "sorts/records.h"
+#include "sorts/typed.h"
+#include "sorts/smallsort.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SORTING FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+typedef void (*Sort_Function)(int64_t* array, size_t array_length);
+
+void quicksort(int64_t* array, size_t array_length);
+// Same as quicksort and introsort, but with the branchless block partition,
+// see partition.h
+void quicksort_block(int64_t* array, size_t array_length);
+void introsort_block(int64_t* array, size_t array_length);
+void quicksort_3way(int64_t* array, size_t array_length);
+// Same as quicksort, quicksort_block and quicksort_3way, but recursing only
+// into the smaller partition, so that the stack is O(log n) deep
+void quicksort_tail(int64_t* array, size_t array_length);
+void quicksort_block_tail(int64_t* array, size_t array_length);
+void quicksort_3way_tail(int64_t* array, size_t array_length);
+void countingsort(int64_t* array, size_t array_length);
+// Same as countingsort, but taking its buffers from the given arena, which is
+// reset before returning, and falling back to radixsort when the counts
+// would not fit in a size_t. countingsort_arena uses sorts_thread_scratch()
+void countingsort_scratch(int64_t* array, size_t array_length, Scratch_Arena* scratch);
+void countingsort_arena(int64_t* array, size_t array_length);
+// Same as countingsort, with counters just wide enough for array_length, and
+// falling back to radixsort when the counts would take more than
+// sorts_counting_memory_cap() bytes
+void countingsort_adaptive(int64_t* array, size_t array_length);
+// Same as countingsort, counting in several interleaved histograms so that
+// runs of equal keys do not serialize on one counter. Falls back to radixsort
+// when the counts would not fit in a size_t.
+void countingsort_multi(int64_t* array, size_t array_length);
+// Uses sorts_thread_count() threads, each counting and scattering its own
+// chunk of the array with its own histogram, arrays too short to be split
+// making a single chunk. Falls back to radixsort when the histogram of a chunk
+// would take more than sorts_counting_memory_cap() bytes.
+void countingsort_parallel(int64_t* array, size_t array_length);
+// LSD radix sort with 8 or 11 bit digits, skipping the digits that are the
+// same for every element
+void radixsort(int64_t* array, size_t array_length);
+void radixsort_11(int64_t* array, size_t array_length);
+void introsort(int64_t* array, size_t array_length);
+// Same as introsort, after pdqsort: sorted and reversed inputs, and sorted
+// ones followed by a few other elements, are sorted in linear time or close,
+// and the bad partitions are shuffled before falling back to heap sort
+void introsort_pdq(int64_t* array, size_t array_length);
+// Uses sorts_thread_count() threads, see task_pool.h
+void introsort_parallel(int64_t* array, size_t array_length);
+// Use sorts_thread_count() threads and a buffer as large as the array. The
+// samplesort classifies the elements in buckets by splitters picked from a
+// random sample, scatters them and sorts the buckets in parallel; the
+// mergesort sorts one run per thread, then every thread merges its share of
+// the output from all the runs. Both sort with introsort_pdq.
+void samplesort_parallel(int64_t* array, size_t array_length);
+void mergesort_parallel(int64_t* array, size_t array_length);
+void std_sort(int64_t* array, size_t array_length);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COUNTING MEMORY CAP
+////////////////////////////////////////////////////////////////////////////////
+
+// About the size of an L2 cache
+#define SORTS_DEFAULT_COUNTING_MEMORY_CAP (1 << 20)
+
+// Most bytes of counters countingsort_adaptive and every chunk of
+// countingsort_parallel allocate, 0 for no cap
+void sorts_set_counting_memory_cap(size_t bytes);
+size_t sorts_counting_memory_cap(void);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// KERNEL REGISTRY
+////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+	// Benchmarked when no algorithm is explicitly asked
+	SORTKERNEL_DEFAULT = 1 << 0,
+	// Honours sorts_set_thread_count, so it is also benchmarked over the
+	// thread count axis
+	SORTKERNEL_PARALLEL = 1 << 1,
+	// Honours sorts_set_pivot_strategy
+	SORTKERNEL_PIVOT_STRATEGY = 1 << 2,
+	// Sorts records through record_function instead of function, so it is
+	// only benchmarked over the payload size axis, in both layouts
+	SORTKERNEL_RECORDS = 1 << 3,
+	// Also sorts every Element_Type through typed_functions
+	SORTKERNEL_ELEMENT_TYPES = 1 << 4,
+	// Honours sorts_set_small_sort, so it is also benchmarked over the leaf
+	// sort and cutoff axes
+	SORTKERNEL_SMALL_SORT = 1 << 5,
+} Sort_Kernel_Flags;
+
+typedef struct {
+	// Used on the command line and as the prefix of the output csv files
+	const char* name;
+	// Used in the progress output
+	const char* display_name;
+	Sort_Function function;
+	unsigned flags;
+	// Only for SORTKERNEL_RECORDS, which have no function
+	Record_Sort_Function record_function;
+	// Only for SORTKERNEL_ELEMENT_TYPES, ELEMENTTYPE_COUNT functions
+	const Typed_Sort_Function* typed_functions;
+} Sort_Kernel;
+
+extern const Sort_Kernel g_sort_kernels[];
+extern const size_t g_sort_kernels_count;
+
+const Sort_Kernel* sortkernel_find(const char* name);
+
+#endif
@@ -0,0 +1,54 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "sorts/stats.h"
+
+static pthread_key_t g_stats_key;
+static pthread_once_t g_stats_key_once = PTHREAD_ONCE_INIT;
+
+static void create_stats_key(void) {
+	int result = pthread_key_create(&g_stats_key, free);
+	assert(result == 0);
+}
+
+Sort_Stats* sorts_stats(void) {
+	pthread_once(&g_stats_key_once, create_stats_key);
+
+	Sort_Stats* stats = pthread_getspecific(g_stats_key);
+	if (stats == NULL) {
+		stats = malloc(sizeof(Sort_Stats));
+		assert(stats != NULL);
+		sortstats_reset(stats);
+
+		pthread_setspecific(g_stats_key, stats);
+	}
+
+	return stats;
+}
+
+void sortstats_reset(Sort_Stats* stats) {
+	stats->peak_recursion_depth = 0;
+	stats->allocation_count = 0;
+	stats->peak_bytes = 0;
+}
+
+void sortstats_record_recursion_depth(size_t depth) {
+	Sort_Stats* stats = sorts_stats();
+	if (depth > stats->peak_recursion_depth) {
+		stats->peak_recursion_depth = depth;
+	}
+}
+
+void sortstats_record_allocations(size_t count) {
+	sorts_stats()->allocation_count += count;
+}
+
+void sortstats_record_bytes(size_t bytes) {
+	Sort_Stats* stats = sorts_stats();
+	if (bytes > stats->peak_bytes) {
+		stats->peak_bytes = bytes;
+	}
+}
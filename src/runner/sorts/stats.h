@@ -0,0 +1,32 @@
+#ifndef SORTS_STATS_H
+#define SORTS_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// KERNEL STATISTICS
+////////////////////////////////////////////////////////////////////////////////
+
+// Statistics of the sorts run by one thread. Kernels only update them once per
+// call, at the end, so that the bookkeeping does not weigh on the measurement.
+typedef struct {
+	// Deepest recursion reached, 0 for kernels that do not recurse or do not
+	// track it
+	size_t peak_recursion_depth;
+	// Heap allocations done by the kernels, scratch arenas included
+	size_t allocation_count;
+	// Most temporary memory held at once by one sort, scratch arenas included
+	size_t peak_bytes;
+} Sort_Stats;
+
+// Statistics of the calling thread
+Sort_Stats* sorts_stats(void);
+
+void sortstats_reset(Sort_Stats* stats);
+void sortstats_record_recursion_depth(size_t depth);
+void sortstats_record_allocations(size_t count);
+void sortstats_record_bytes(size_t bytes);
+
+#endif
@@ -0,0 +1,18 @@
+#include <stdlib.h>
+
+#include "sorts/sorts.h"
+
+// Template kernel: copy this file to add a new algorithm, then register it in
+// registry.c and add the source to the sort_runner target in CMakeLists.txt.
+
+static int sort_compare(const void* left, const void* right) {
+	int64_t l = *(const int64_t*)left;
+	int64_t r = *(const int64_t*)right;
+
+	// The difference would not fit in an int
+	return (l > r) - (l < r);
+}
+
+void std_sort(int64_t* array, size_t array_length) {
+	qsort(array, array_length, sizeof(int64_t), sort_compare);
+}
@@ -0,0 +1,321 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "sorts/task_pool.h"
+
+typedef struct {
+	pthread_mutex_t mutex;
+
+	// The owner pushes and pops at the bottom, thieves steal from the top
+	Task* tasks;
+	size_t tasks_capacity;
+	size_t top;
+	size_t bottom;
+} Task_Queue;
+
+typedef struct {
+	Task_Pool* pool;
+	size_t worker_index;
+} Task_Worker;
+
+struct Task_Pool {
+	size_t thread_count;
+	pthread_t* threads;
+	Task_Worker* workers;
+	Task_Queue* queues;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t work_available;
+	size_t pending_tasks;
+	bool shutting_down;
+
+	pthread_mutex_t run_mutex;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// QUEUES
+////////////////////////////////////////////////////////////////////////////////
+
+void taskqueue_create(Task_Queue* queue) {
+	pthread_mutex_init(&queue->mutex, NULL);
+
+	queue->tasks_capacity = 64;
+	queue->tasks = malloc(sizeof(Task) * queue->tasks_capacity);
+	assert(queue->tasks != NULL);
+	queue->top = 0;
+	queue->bottom = 0;
+}
+
+void taskqueue_destroy(Task_Queue* queue) {
+	free(queue->tasks);
+	pthread_mutex_destroy(&queue->mutex);
+}
+
+void taskqueue_push(Task_Queue* queue, Task task) {
+	pthread_mutex_lock(&queue->mutex);
+
+	if (queue->bottom == queue->tasks_capacity) {
+		queue->tasks_capacity *= 2;
+		queue->tasks = realloc(queue->tasks, sizeof(Task) * queue->tasks_capacity);
+		assert(queue->tasks != NULL);
+	}
+	queue->tasks[queue->bottom] = task;
+	queue->bottom += 1;
+
+	pthread_mutex_unlock(&queue->mutex);
+}
+
+bool taskqueue_pop(Task_Queue* queue, Task* task) {
+	pthread_mutex_lock(&queue->mutex);
+
+	bool found = queue->top != queue->bottom;
+	if (found) {
+		queue->bottom -= 1;
+		*task = queue->tasks[queue->bottom];
+	}
+	if (queue->top == queue->bottom) {
+		queue->top = 0;
+		queue->bottom = 0;
+	}
+
+	pthread_mutex_unlock(&queue->mutex);
+	return found;
+}
+
+bool taskqueue_steal(Task_Queue* queue, Task* task) {
+	pthread_mutex_lock(&queue->mutex);
+
+	bool found = queue->top != queue->bottom;
+	if (found) {
+		*task = queue->tasks[queue->top];
+		queue->top += 1;
+	}
+	if (queue->top == queue->bottom) {
+		queue->top = 0;
+		queue->bottom = 0;
+	}
+
+	pthread_mutex_unlock(&queue->mutex);
+	return found;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// POOL
+////////////////////////////////////////////////////////////////////////////////
+
+bool taskpool_find_task(Task_Pool* pool, size_t worker_index, Task* task) {
+	if (taskqueue_pop(&pool->queues[worker_index], task)) {
+		return true;
+	}
+
+	for (size_t i = 1; i < pool->thread_count; i += 1) {
+		size_t victim = (worker_index + i) % pool->thread_count;
+		if (taskqueue_steal(&pool->queues[victim], task)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void taskpool_execute(Task_Pool* pool, size_t worker_index, Task task) {
+	task.function(pool, worker_index, task);
+
+	pthread_mutex_lock(&pool->mutex);
+	pool->pending_tasks -= 1;
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+void* taskpool_worker_thread(void* user_data) {
+	Task_Worker* worker = user_data;
+	Task_Pool* pool = worker->pool;
+
+	for (;;) {
+		Task task;
+		if (taskpool_find_task(pool, worker->worker_index, &task)) {
+			taskpool_execute(pool, worker->worker_index, task);
+			continue;
+		}
+
+		pthread_mutex_lock(&pool->mutex);
+		while (pool->pending_tasks == 0 && !pool->shutting_down) {
+			pthread_cond_wait(&pool->work_available, &pool->mutex);
+		}
+		bool shutting_down = pool->shutting_down;
+		pthread_mutex_unlock(&pool->mutex);
+
+		if (shutting_down) {
+			break;
+		}
+
+		// Some tasks are still running but none can be stolen yet
+		sched_yield();
+	}
+
+	return NULL;
+}
+
+Task_Pool* taskpool_create(size_t thread_count) {
+	assert(thread_count > 0);
+
+	Task_Pool* pool = malloc(sizeof(Task_Pool));
+	assert(pool != NULL);
+
+	pool->thread_count = thread_count;
+	pool->pending_tasks = 0;
+	pool->shutting_down = false;
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->work_available, NULL);
+	pthread_mutex_init(&pool->run_mutex, NULL);
+
+	pool->queues = malloc(sizeof(Task_Queue) * thread_count);
+	pool->workers = malloc(sizeof(Task_Worker) * thread_count);
+	pool->threads = malloc(sizeof(pthread_t) * thread_count);
+	assert(pool->queues != NULL && pool->workers != NULL && pool->threads != NULL);
+
+	for (size_t i = 0; i < thread_count; i += 1) {
+		taskqueue_create(&pool->queues[i]);
+		pool->workers[i].pool = pool;
+		pool->workers[i].worker_index = i;
+	}
+
+	// Worker 0 is whichever thread calls taskpool_run
+	for (size_t i = 1; i < thread_count; i += 1) {
+		int result = pthread_create(&pool->threads[i], NULL, taskpool_worker_thread, &pool->workers[i]);
+		assert(result == 0);
+	}
+
+	return pool;
+}
+
+void taskpool_destroy(Task_Pool* pool) {
+	pthread_mutex_lock(&pool->mutex);
+	pool->shutting_down = true;
+	pthread_cond_broadcast(&pool->work_available);
+	pthread_mutex_unlock(&pool->mutex);
+
+	for (size_t i = 1; i < pool->thread_count; i += 1) {
+		pthread_join(pool->threads[i], NULL);
+	}
+	for (size_t i = 0; i < pool->thread_count; i += 1) {
+		taskqueue_destroy(&pool->queues[i]);
+	}
+
+	pthread_mutex_destroy(&pool->run_mutex);
+	pthread_cond_destroy(&pool->work_available);
+	pthread_mutex_destroy(&pool->mutex);
+
+	free(pool->queues);
+	free(pool->workers);
+	free(pool->threads);
+	free(pool);
+}
+
+size_t taskpool_thread_count(const Task_Pool* pool) {
+	return pool->thread_count;
+}
+
+void taskpool_spawn(Task_Pool* pool, size_t worker_index, Task task) {
+	// The spawning task is itself still pending, so the counter can not reach
+	// zero between this increment and the push. Idle workers are already awake
+	// for the whole run, so there is no need to signal them.
+	pthread_mutex_lock(&pool->mutex);
+	pool->pending_tasks += 1;
+	pthread_mutex_unlock(&pool->mutex);
+
+	taskqueue_push(&pool->queues[worker_index], task);
+}
+
+void taskpool_run(Task_Pool* pool, Task root) {
+	pthread_mutex_lock(&pool->run_mutex);
+
+	pthread_mutex_lock(&pool->mutex);
+	pool->pending_tasks += 1;
+	pthread_cond_broadcast(&pool->work_available);
+	pthread_mutex_unlock(&pool->mutex);
+
+	taskpool_execute(pool, 0, root);
+
+	for (;;) {
+		Task task;
+		if (taskpool_find_task(pool, 0, &task)) {
+			taskpool_execute(pool, 0, task);
+			continue;
+		}
+
+		pthread_mutex_lock(&pool->mutex);
+		bool finished = pool->pending_tasks == 0;
+		pthread_mutex_unlock(&pool->mutex);
+
+		if (finished) {
+			break;
+		}
+		sched_yield();
+	}
+
+	pthread_mutex_unlock(&pool->run_mutex);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SHARED POOL
+////////////////////////////////////////////////////////////////////////////////
+
+struct {
+	pthread_mutex_t mutex;
+	size_t thread_count;
+	Task_Pool* pool;
+} g_sorts_pool = { PTHREAD_MUTEX_INITIALIZER, 0, NULL };
+
+void sorts_set_thread_count(size_t thread_count) {
+	pthread_mutex_lock(&g_sorts_pool.mutex);
+	g_sorts_pool.thread_count = thread_count;
+	pthread_mutex_unlock(&g_sorts_pool.mutex);
+}
+
+size_t sorts_thread_count(void) {
+	pthread_mutex_lock(&g_sorts_pool.mutex);
+	size_t thread_count = g_sorts_pool.thread_count;
+	pthread_mutex_unlock(&g_sorts_pool.mutex);
+
+	if (thread_count == 0) {
+		long online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		thread_count = online_cpus > 0 ? (size_t)online_cpus : 1;
+	}
+
+	return thread_count;
+}
+
+Task_Pool* sorts_task_pool(void) {
+	size_t thread_count = sorts_thread_count();
+
+	pthread_mutex_lock(&g_sorts_pool.mutex);
+	if (g_sorts_pool.pool != NULL && taskpool_thread_count(g_sorts_pool.pool) != thread_count) {
+		taskpool_destroy(g_sorts_pool.pool);
+		g_sorts_pool.pool = NULL;
+	}
+	if (g_sorts_pool.pool == NULL) {
+		g_sorts_pool.pool = taskpool_create(thread_count);
+	}
+	Task_Pool* pool = g_sorts_pool.pool;
+	pthread_mutex_unlock(&g_sorts_pool.mutex);
+
+	return pool;
+}
+
+void sorts_terminate(void) {
+	pthread_mutex_lock(&g_sorts_pool.mutex);
+	if (g_sorts_pool.pool != NULL) {
+		taskpool_destroy(g_sorts_pool.pool);
+		g_sorts_pool.pool = NULL;
+	}
+	pthread_mutex_unlock(&g_sorts_pool.mutex);
+}
@@ -0,0 +1,58 @@
+#ifndef SORTS_TASK_POOL_H
+#define SORTS_TASK_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// WORK STEALING TASK POOL
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct Task_Pool Task_Pool;
+
+typedef struct Task {
+	// worker_index identifies the thread running the task and must be passed
+	// to taskpool_spawn by the task itself
+	void (*function)(Task_Pool* pool, size_t worker_index, struct Task task);
+
+	int64_t* array;
+	size_t array_length;
+	size_t depth;
+	// Free for kernels that split their work in numbered pieces sharing some
+	// state, such as the chunks of countingsort_parallel
+	size_t index;
+	void* user_data;
+} Task;
+
+Task_Pool* taskpool_create(size_t thread_count);
+void taskpool_destroy(Task_Pool* pool);
+
+size_t taskpool_thread_count(const Task_Pool* pool);
+
+// Runs root and every task spawned from it, using the calling thread as one of
+// the workers. Returns once all of them have finished. Concurrent calls on the
+// same pool are serialized.
+void taskpool_run(Task_Pool* pool, Task root);
+
+// Pushes a task on the queue of the calling worker, where idle workers can
+// steal it. Must only be called from inside a running task.
+void taskpool_spawn(Task_Pool* pool, size_t worker_index, Task task);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SHARED POOL
+////////////////////////////////////////////////////////////////////////////////
+
+// Number of threads used by the parallel kernels. 0 (the default) uses one
+// thread per online cpu.
+void sorts_set_thread_count(size_t thread_count);
+size_t sorts_thread_count(void);
+
+// Pool shared by the parallel kernels, (re)created lazily with
+// sorts_thread_count() threads so that the kernels do not pay for spawning
+// threads on every call.
+Task_Pool* sorts_task_pool(void);
+void sorts_terminate(void);
+
+#endif
@@ -0,0 +1,542 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#include "sorts/sorts.h"
+#include "sorts/typed.h"
+#include "sorts/partition.h"
+#include "sorts/stats.h"
+
+// The instantiations follow the int64_t kernels they are named after, so that
+// the element types can be compared against each other
+
+#define TYPED_RADIX_DIGIT_BITS 8
+#define TYPED_RADIX_BUCKETS (1 << TYPED_RADIX_DIGIT_BITS)
+
+static const char* g_element_type_names[ELEMENTTYPE_COUNT] = {
+	"int64",
+	"uint64",
+	"double",
+	"int32",
+	"uint32",
+	"float",
+};
+
+static const size_t g_element_type_sizes[ELEMENTTYPE_COUNT] = {
+	sizeof(int64_t),
+	sizeof(uint64_t),
+	sizeof(double),
+	sizeof(int32_t),
+	sizeof(uint32_t),
+	sizeof(float),
+};
+
+const char* elementtype_name(Element_Type type) {
+	assert(type < ELEMENTTYPE_COUNT);
+	return g_element_type_names[type];
+}
+
+bool elementtype_parse(const char* name, Element_Type* type) {
+	for (size_t i = 0; i < ELEMENTTYPE_COUNT; i += 1) {
+		if (strcmp(g_element_type_names[i], name) == 0) {
+			*type = (Element_Type)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+size_t elementtype_size(Element_Type type) {
+	assert(type < ELEMENTTYPE_COUNT);
+	return g_element_type_sizes[type];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// KEY TRANSFORMS
+////////////////////////////////////////////////////////////////////////////////
+
+// Unsigned keys whose order is the order of the elements
+
+static uint32_t typed_key_int32(int32_t element) {
+	return (uint32_t)element ^ 0x80000000U;
+}
+
+static uint32_t typed_key_uint32(uint32_t element) {
+	return element;
+}
+
+static uint64_t typed_key_uint64(uint64_t element) {
+	return element;
+}
+
+// -0.0 gets a smaller key than 0.0, which is fine as they compare equal
+static uint32_t typed_key_float(float element) {
+	uint32_t bits;
+	memcpy(&bits, &element, sizeof(bits));
+
+	return bits ^ ((uint32_t)-(int32_t)(bits >> 31) | 0x80000000U);
+}
+
+static uint64_t typed_key_double(double element) {
+	uint64_t bits;
+	memcpy(&bits, &element, sizeof(bits));
+
+	return bits ^ ((uint64_t)-(int64_t)(bits >> 63) | 0x8000000000000000ULL);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COMPARISON SORTS
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	Pivot_Strategy pivot_strategy;
+	uint64_t random_state;
+	// Partitions of at most leaf_cutoff elements are sorted by the networks of
+	// the leaf sort when they are set, by insertion sort otherwise
+	size_t leaf_cutoff;
+	const Network_Comparator* network_comparators;
+	const size_t* network_offsets;
+
+	size_t depth;
+	size_t peak_depth;
+} Typed_Context;
+
+// The leaf is the one of the int64_t kernel, default_leaf_cutoff being its
+// cutoff with SMALLSORT_DEFAULT. The leaf functions only sort int64_t, so the
+// other types run the same algorithm on their own elements: SMALLSORT_SIMD has
+// no registers of them and falls back to the network.
+static void typed_context_create(Typed_Context* context, size_t default_leaf_cutoff) {
+	context->pivot_strategy = sorts_pivot_strategy();
+	context->random_state = PIVOT_RANDOM_SEED;
+	context->leaf_cutoff = sorts_small_sort_leaf(default_leaf_cutoff).cutoff;
+	context->network_comparators = NULL;
+	context->network_offsets = NULL;
+	if (sorts_small_sort() == SMALLSORT_NETWORK || sorts_small_sort() == SMALLSORT_SIMD) {
+		context->network_comparators = smallsort_networks(&context->network_offsets);
+	}
+	context->depth = 0;
+	context->peak_depth = 0;
+}
+
+static void typed_context_enter(Typed_Context* context) {
+	context->depth += 1;
+	if (context->depth > context->peak_depth) {
+		context->peak_depth = context->depth;
+	}
+}
+
+// Defines quicksort, quicksort_3way, introsort and std_sort for arrays of Type
+#define TYPED_DEFINE_COMPARISON_SORTS(suffix, Type) \
+	PIVOT_DEFINE_SELECT(pivot_select_##suffix, Type) \
+	\
+	static void swap_##suffix(Type* a, Type* b) { \
+		Type t = *a; \
+		*a = *b; \
+		*b = t; \
+	} \
+	\
+	static void insertion_sort_##suffix(Type* array, size_t array_length) { \
+		for (size_t i = 1; i < array_length; i += 1) { \
+			Type key = array[i]; \
+			size_t j = i; \
+			\
+			while (j > 0 && array[j - 1] > key) { \
+				array[j] = array[j - 1]; \
+				j -= 1; \
+			} \
+			array[j] = key; \
+		} \
+	} \
+	\
+	/* Same compare-exchanges as small_sort_network, as conditional moves */ \
+	static void network_sort_##suffix(Type* array, size_t array_length, const Typed_Context* context) { \
+		const Network_Comparator* comparator = &context->network_comparators[context->network_offsets[array_length]]; \
+		const Network_Comparator* end = &context->network_comparators[context->network_offsets[array_length + 1]]; \
+		for (; comparator < end; comparator += 1) { \
+			Type a = array[comparator->low]; \
+			Type b = array[comparator->high]; \
+			bool greater = a > b; \
+			\
+			array[comparator->low] = greater ? b : a; \
+			array[comparator->high] = greater ? a : b; \
+		} \
+	} \
+	\
+	static void leaf_sort_##suffix(Type* array, size_t array_length, const Typed_Context* context) { \
+		if (context->network_comparators != NULL) { \
+			network_sort_##suffix(array, array_length, context); \
+		} else { \
+			insertion_sort_##suffix(array, array_length); \
+		} \
+	} \
+	\
+	static void sift_down_##suffix(Type* heap, size_t index, size_t element_count) { \
+		for (;;) { \
+			size_t swap_index = index; \
+			size_t left = index * 2 + 1; \
+			size_t right = index * 2 + 2; \
+			\
+			if (left < element_count && heap[left] > heap[swap_index]) { \
+				swap_index = left; \
+			} \
+			if (right < element_count && heap[right] > heap[swap_index]) { \
+				swap_index = right; \
+			} \
+			if (swap_index == index) { \
+				return; \
+			} \
+			\
+			swap_##suffix(&heap[index], &heap[swap_index]); \
+			index = swap_index; \
+		} \
+	} \
+	\
+	static void heap_sort_##suffix(Type* array, size_t array_length) { \
+		for (size_t i = array_length / 2; i > 0; i -= 1) { \
+			sift_down_##suffix(array, i - 1, array_length); \
+		} \
+		for (size_t element_count = array_length; element_count > 1; element_count -= 1) { \
+			swap_##suffix(&array[0], &array[element_count - 1]); \
+			sift_down_##suffix(array, 0, element_count - 1); \
+		} \
+	} \
+	\
+	/* Lomuto partition of array[low..high] around its last element, after */ \
+	/* moving the pivot of the context there */ \
+	static size_t partition_##suffix(Type* array, size_t low, size_t high, Typed_Context* context) { \
+		size_t pivot_index = pivot_select_##suffix(array, low, high, high, context->pivot_strategy, &context->random_state); \
+		swap_##suffix(&array[pivot_index], &array[high]); \
+		\
+		Type pivot = array[high]; \
+		size_t i = low; \
+		for (size_t j = low; j < high; j += 1) { \
+			if (array[j] < pivot) { \
+				swap_##suffix(&array[i], &array[j]); \
+				i += 1; \
+			} \
+		} \
+		swap_##suffix(&array[i], &array[high]); \
+		return i; \
+	} \
+	\
+	static void quicksort_rec_##suffix(Type* array, size_t low, size_t high, Typed_Context* context) { \
+		typed_context_enter(context); \
+		\
+		if (low >= high) { \
+			/* Nothing to sort */ \
+		} else if (high - low + 1 <= context->leaf_cutoff) { \
+			leaf_sort_##suffix(array + low, high - low + 1, context); \
+		} else { \
+			size_t p = partition_##suffix(array, low, high, context); \
+			\
+			if (p > low) { \
+				quicksort_rec_##suffix(array, low, p - 1, context); \
+			} \
+			quicksort_rec_##suffix(array, p + 1, high, context); \
+		} \
+		\
+		context->depth -= 1; \
+	} \
+	\
+	static void typed_quicksort_##suffix(void* array, size_t array_length) { \
+		Typed_Context context; \
+		/* No leaf sort by default, partitioning down to single elements */ \
+		typed_context_create(&context, 0); \
+		\
+		if (array_length > 1) { \
+			quicksort_rec_##suffix(array, 0, array_length - 1, &context); \
+		} \
+		\
+		sortstats_record_recursion_depth(context.peak_depth); \
+	} \
+	\
+	/* Same three way partition as quicksort_3way, around the first element */ \
+	static void quicksort_3way_rec_##suffix(Type* a, size_t lo, size_t hi, Typed_Context* context) { \
+		typed_context_enter(context); \
+		\
+		if (lo >= hi) { \
+			/* Nothing to sort */ \
+		} else if (hi - lo + 1 <= context->leaf_cutoff) { \
+			leaf_sort_##suffix(a + lo, hi - lo + 1, context); \
+		} else { \
+			size_t pivot_index = pivot_select_##suffix(a, lo, hi, lo, context->pivot_strategy, &context->random_state); \
+			swap_##suffix(&a[pivot_index], &a[lo]); \
+			Type pivot = a[lo]; \
+			\
+			size_t lt = lo, i = lo + 1, gt = hi; \
+			while (i <= gt) { \
+				if (a[i] < pivot) { \
+					swap_##suffix(&a[lt], &a[i]); \
+					lt += 1; \
+					i += 1; \
+				} else if (a[i] > pivot) { \
+					swap_##suffix(&a[i], &a[gt]); \
+					gt -= 1; \
+				} else { \
+					i += 1; \
+				} \
+			} \
+			\
+			if (lt > lo) { \
+				quicksort_3way_rec_##suffix(a, lo, lt - 1, context); \
+			} \
+			quicksort_3way_rec_##suffix(a, gt + 1, hi, context); \
+		} \
+		\
+		context->depth -= 1; \
+	} \
+	\
+	static void typed_quicksort_3way_##suffix(void* array, size_t array_length) { \
+		Typed_Context context; \
+		typed_context_create(&context, 0); \
+		\
+		if (array_length > 1) { \
+			quicksort_3way_rec_##suffix(array, 0, array_length - 1, &context); \
+		} \
+		\
+		sortstats_record_recursion_depth(context.peak_depth); \
+	} \
+	\
+	static void introsort_helper_##suffix(Type* array, size_t low, size_t high, size_t max_depth, Typed_Context* context) { \
+		size_t section_length = high - low + 1; \
+		\
+		typed_context_enter(context); \
+		\
+		if (section_length <= context->leaf_cutoff) { \
+			leaf_sort_##suffix(array + low, section_length, context); \
+		} else if (max_depth == 0) { \
+			heap_sort_##suffix(array + low, section_length); \
+		} else { \
+			size_t p = partition_##suffix(array, low, high, context); \
+			\
+			if (p > low) { \
+				introsort_helper_##suffix(array, low, p - 1, max_depth - 1, context); \
+			} \
+			if (p < high) { \
+				introsort_helper_##suffix(array, p + 1, high, max_depth - 1, context); \
+			} \
+		} \
+		\
+		context->depth -= 1; \
+	} \
+	\
+	static void typed_introsort_##suffix(void* array, size_t array_length) { \
+		if (array_length == 0) { \
+			return; \
+		} \
+		\
+		Typed_Context context; \
+		/* Partitions shorter than 16 elements are insertion sorted by default */ \
+		typed_context_create(&context, 15); \
+		\
+		size_t max_depth = (size_t)log2(array_length) * 2; \
+		introsort_helper_##suffix(array, 0, array_length - 1, max_depth, &context); \
+		\
+		sortstats_record_recursion_depth(context.peak_depth); \
+	} \
+	\
+	static int compare_##suffix(const void* left, const void* right) { \
+		Type l = *(const Type*)left; \
+		Type r = *(const Type*)right; \
+		return (l > r) - (l < r); \
+	} \
+	\
+	static void typed_std_sort_##suffix(void* array, size_t array_length) { \
+		qsort(array, array_length, sizeof(Type), compare_##suffix); \
+	}
+
+TYPED_DEFINE_COMPARISON_SORTS(uint64, uint64_t)
+TYPED_DEFINE_COMPARISON_SORTS(double, double)
+TYPED_DEFINE_COMPARISON_SORTS(int32, int32_t)
+TYPED_DEFINE_COMPARISON_SORTS(uint32, uint32_t)
+TYPED_DEFINE_COMPARISON_SORTS(float, float)
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DISTRIBUTION SORTS
+////////////////////////////////////////////////////////////////////////////////
+
+// Defines a counting sort of the elements of array by their keys, with
+// element_count counters of the given type, which must hold array_length
+#define TYPED_DEFINE_COUNTING_WITH_BUFFERS(function_name, Type, Key, key_function, Counter) \
+	static void function_name(Type* array, size_t array_length, Key min_key, size_t element_count, Counter* counts_array, Type* results_array) { \
+		memset(counts_array, 0, element_count * sizeof(Counter)); \
+		\
+		for (size_t i = 0; i < array_length; i += 1) { \
+			counts_array[key_function(array[i]) - min_key] += 1; \
+		} \
+		\
+		for (size_t i = 1; i < element_count; i += 1) { \
+			counts_array[i] += counts_array[i - 1]; \
+		} \
+		\
+		for (size_t i = array_length; i > 0; i -= 1) { \
+			Key key = key_function(array[i - 1]) - min_key; \
+			counts_array[key] -= 1; \
+			results_array[counts_array[key]] = array[i - 1]; \
+		} \
+		\
+		memcpy(array, results_array, array_length * sizeof(Type)); \
+	}
+
+// Defines radixsort (8 bit digits) and countingsort_adaptive for arrays of
+// Type, sorting them by the Key given by key_function
+#define TYPED_DEFINE_DISTRIBUTION_SORTS(suffix, Type, Key, key_function) \
+	static void typed_radixsort_##suffix(void* untyped_array, size_t array_length) { \
+		Type* array = untyped_array; \
+		if (array_length < 2) { \
+			return; \
+		} \
+		\
+		size_t pass_count = sizeof(Key) * 8 / TYPED_RADIX_DIGIT_BITS; \
+		size_t* histograms = calloc(pass_count * TYPED_RADIX_BUCKETS, sizeof(size_t)); \
+		Type* buffer = malloc(array_length * sizeof(Type)); \
+		assert(histograms != NULL && buffer != NULL); \
+		sortstats_record_allocations(2); \
+		sortstats_record_bytes(pass_count * TYPED_RADIX_BUCKETS * sizeof(size_t) + array_length * sizeof(Type)); \
+		\
+		for (size_t i = 0; i < array_length; i += 1) { \
+			Key key = key_function(array[i]); \
+			\
+			for (size_t pass = 0; pass < pass_count; pass += 1) { \
+				histograms[pass * TYPED_RADIX_BUCKETS + ((key >> (pass * TYPED_RADIX_DIGIT_BITS)) & (TYPED_RADIX_BUCKETS - 1))] += 1; \
+			} \
+		} \
+		\
+		Type* source = array; \
+		Type* destination = buffer; \
+		for (size_t pass = 0; pass < pass_count; pass += 1) { \
+			size_t* histogram = &histograms[pass * TYPED_RADIX_BUCKETS]; \
+			unsigned shift = (unsigned)(pass * TYPED_RADIX_DIGIT_BITS); \
+			\
+			size_t first_digit = (key_function(source[0]) >> shift) & (TYPED_RADIX_BUCKETS - 1); \
+			if (histogram[first_digit] == array_length) { \
+				continue; \
+			} \
+			\
+			size_t offset = 0; \
+			for (size_t digit = 0; digit < TYPED_RADIX_BUCKETS; digit += 1) { \
+				size_t count = histogram[digit]; \
+				histogram[digit] = offset; \
+				offset += count; \
+			} \
+			\
+			for (size_t i = 0; i < array_length; i += 1) { \
+				size_t digit = (key_function(source[i]) >> shift) & (TYPED_RADIX_BUCKETS - 1); \
+				destination[histogram[digit]] = source[i]; \
+				histogram[digit] += 1; \
+			} \
+			\
+			Type* tmp = source; \
+			source = destination; \
+			destination = tmp; \
+		} \
+		\
+		if (source != array) { \
+			memcpy(array, source, array_length * sizeof(Type)); \
+		} \
+		\
+		free(histograms); \
+		free(buffer); \
+	} \
+	\
+	TYPED_DEFINE_COUNTING_WITH_BUFFERS(countingsort_with_buffers_##suffix, Type, Key, key_function, uint64_t) \
+	TYPED_DEFINE_COUNTING_WITH_BUFFERS(countingsort_with_buffers_32_##suffix, Type, Key, key_function, uint32_t) \
+	TYPED_DEFINE_COUNTING_WITH_BUFFERS(countingsort_with_buffers_16_##suffix, Type, Key, key_function, uint16_t) \
+	\
+	static void typed_countingsort_adaptive_##suffix(void* untyped_array, size_t array_length) { \
+		Type* array = untyped_array; \
+		if (array_length < 2) { \
+			return; \
+		} \
+		\
+		Key min_key = key_function(array[0]); \
+		Key max_key = min_key; \
+		for (size_t i = 1; i < array_length; i += 1) { \
+			Key key = key_function(array[i]); \
+			min_key = key < min_key ? key : min_key; \
+			max_key = key > max_key ? key : max_key; \
+		} \
+		\
+		size_t counter_size = sizeof(uint64_t); \
+		if (array_length <= UINT16_MAX) { \
+			counter_size = sizeof(uint16_t); \
+		} else if (array_length <= UINT32_MAX) { \
+			counter_size = sizeof(uint32_t); \
+		} \
+		\
+		/* The keys of floating point elements are sparse, so even small */ \
+		/* ranges of values usually take this path */ \
+		Key key_range = max_key - min_key; \
+		size_t memory_cap = sorts_counting_memory_cap(); \
+		if ((memory_cap != 0 && key_range >= memory_cap / counter_size) || key_range >= SIZE_MAX / counter_size) { \
+			typed_radixsort_##suffix(array, array_length); \
+			return; \
+		} \
+		\
+		size_t element_count = (size_t)key_range + 1; \
+		void* counts_array = malloc(element_count * counter_size); \
+		Type* results_array = malloc(array_length * sizeof(Type)); \
+		assert(counts_array != NULL && results_array != NULL); \
+		sortstats_record_allocations(2); \
+		sortstats_record_bytes(element_count * counter_size + array_length * sizeof(Type)); \
+		\
+		switch (counter_size) { \
+		case sizeof(uint16_t): \
+			countingsort_with_buffers_16_##suffix(array, array_length, min_key, element_count, counts_array, results_array); break; \
+		case sizeof(uint32_t): \
+			countingsort_with_buffers_32_##suffix(array, array_length, min_key, element_count, counts_array, results_array); break; \
+		default: \
+			countingsort_with_buffers_##suffix(array, array_length, min_key, element_count, counts_array, results_array); break; \
+		} \
+		\
+		free(counts_array); \
+		free(results_array); \
+	}
+
+TYPED_DEFINE_DISTRIBUTION_SORTS(uint64, uint64_t, uint64_t, typed_key_uint64)
+TYPED_DEFINE_DISTRIBUTION_SORTS(double, double, uint64_t, typed_key_double)
+TYPED_DEFINE_DISTRIBUTION_SORTS(int32, int32_t, uint32_t, typed_key_int32)
+TYPED_DEFINE_DISTRIBUTION_SORTS(uint32, uint32_t, uint32_t, typed_key_uint32)
+TYPED_DEFINE_DISTRIBUTION_SORTS(float, float, uint32_t, typed_key_float)
+
+
+////////////////////////////////////////////////////////////////////////////////
+// KERNEL TABLES
+////////////////////////////////////////////////////////////////////////////////
+
+// Defines the ELEMENTTYPE_INT64 entry of a table, calling the original kernel
+#define TYPED_DEFINE_INT64(kernel) \
+	static void typed_##kernel##_int64(void* array, size_t array_length) { \
+		kernel(array, array_length); \
+	}
+
+TYPED_DEFINE_INT64(quicksort)
+TYPED_DEFINE_INT64(quicksort_3way)
+TYPED_DEFINE_INT64(introsort)
+TYPED_DEFINE_INT64(radixsort)
+TYPED_DEFINE_INT64(countingsort_adaptive)
+TYPED_DEFINE_INT64(std_sort)
+
+#define TYPED_TABLE(kernel) { \
+		typed_##kernel##_int64, \
+		typed_##kernel##_uint64, \
+		typed_##kernel##_double, \
+		typed_##kernel##_int32, \
+		typed_##kernel##_uint32, \
+		typed_##kernel##_float, \
+	}
+
+const Typed_Sort_Function g_quicksort_typed[ELEMENTTYPE_COUNT] = TYPED_TABLE(quicksort);
+const Typed_Sort_Function g_quicksort_3way_typed[ELEMENTTYPE_COUNT] = TYPED_TABLE(quicksort_3way);
+const Typed_Sort_Function g_introsort_typed[ELEMENTTYPE_COUNT] = TYPED_TABLE(introsort);
+const Typed_Sort_Function g_radixsort_typed[ELEMENTTYPE_COUNT] = TYPED_TABLE(radixsort);
+const Typed_Sort_Function g_countingsort_adaptive_typed[ELEMENTTYPE_COUNT] = TYPED_TABLE(countingsort_adaptive);
+const Typed_Sort_Function g_std_sort_typed[ELEMENTTYPE_COUNT] = TYPED_TABLE(std_sort);
@@ -0,0 +1,53 @@
+#ifndef SORTS_TYPED_H
+#define SORTS_TYPED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ELEMENT TYPES
+////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+	// The type of Sort_Function (default)
+	ELEMENTTYPE_INT64,
+	ELEMENTTYPE_UINT64,
+	ELEMENTTYPE_DOUBLE,
+	ELEMENTTYPE_INT32,
+	ELEMENTTYPE_UINT32,
+	ELEMENTTYPE_FLOAT,
+
+	ELEMENTTYPE_COUNT,
+} Element_Type;
+
+const char* elementtype_name(Element_Type type);
+bool elementtype_parse(const char* name, Element_Type* type);
+// Bytes of one element
+size_t elementtype_size(Element_Type type);
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPED SORTING FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////
+
+// Sorts array_length elements of one of the element types
+typedef void (*Typed_Sort_Function)(void* array, size_t array_length);
+
+// The kernels instantiated for every element type, indexed by Element_Type.
+// The ELEMENTTYPE_INT64 entries call the original kernels. Floating point
+// arrays must not hold NaNs.
+// The comparison sorts honour the pivot strategy and the leaf sort like the
+// original kernels, SMALLSORT_SIMD being the network for the other types.
+extern const Typed_Sort_Function g_quicksort_typed[ELEMENTTYPE_COUNT];
+extern const Typed_Sort_Function g_quicksort_3way_typed[ELEMENTTYPE_COUNT];
+extern const Typed_Sort_Function g_introsort_typed[ELEMENTTYPE_COUNT];
+// Radix and counting sort work on unsigned keys with the order of the
+// elements: the sign bit of signed integers is flipped, and so is every bit of
+// negative floats (only the sign bit of the positive ones)
+extern const Typed_Sort_Function g_radixsort_typed[ELEMENTTYPE_COUNT];
+extern const Typed_Sort_Function g_countingsort_adaptive_typed[ELEMENTTYPE_COUNT];
+extern const Typed_Sort_Function g_std_sort_typed[ELEMENTTYPE_COUNT];
+
+#endif
@@ -47,6 +47,9 @@ try:
 
     for file_path in csv_files:
         titolo = os.path.splitext(os.path.basename(file_path))[0]
+        # I campioni di -n non sono tempi per numero di elementi
+        if ".samples" in titolo:
+            continue
         tempi = []
         numero_elementi = []
 